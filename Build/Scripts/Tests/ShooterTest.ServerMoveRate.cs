@@ -0,0 +1,35 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+using EpicGame;
+using Gauntlet;
+
+namespace ShooterTest
+{
+	/// <summary>
+	/// Joins a dedicated server like DedicatedServerTest, then the client logs how many ServerMove RPCs it sends per second.
+	/// </summary>
+	public class ServerMoveRate : UnrealTestNode<ShooterTestConfig>
+	{
+		public ServerMoveRate(UnrealTestContext InContext) : base(InContext)
+		{
+		}
+
+		public override ShooterTestConfig GetConfiguration()
+		{
+			ShooterTestConfig Config = base.GetConfiguration();
+			Config.PreAssignAccount = false;
+			Config.NoMCP = true;
+
+			UnrealTestRole Client = Config.RequireRole(UnrealTargetRole.Client);
+			UnrealTestRole Server = Config.RequireRole(UnrealTargetRole.Server);
+
+			Client.Controllers.Add("ServerMoveRate");
+
+			return Config;
+		}
+	}
+}
@@ -10,6 +10,9 @@ public class ShooterClientTarget : TargetRules
 		Type = TargetType.Client;
 		bUsesSteam = true;		
 
+        // Replicated properties of the character, weapons and player state are push based (see ShooterPushModel.h)
+        bWithPushModel = true;
+
         ExtraModuleNames.Add("ShooterGame");
     }
 }
@@ -10,6 +10,9 @@ public class ShooterGameTarget : TargetRules
         Type = TargetType.Game;
         bUsesSteam = true;
 
+		// Replicated properties of the character, weapons and player state are push based (see ShooterPushModel.h)
+		bWithPushModel = true;
+
 		ExtraModuleNames.Add("ShooterGame");
     }
 }
@@ -3,6 +3,7 @@
 #include "ShooterGame.h"
 #include "Bots/ShooterBot.h"
 #include "Bots/ShooterAIController.h"
+#include "Bots/ShooterBotMovementLODSubsystem.h"
 
 AShooterBot::AShooterBot(const FObjectInitializer& ObjectInitializer) 
 	: Super(ObjectInitializer)
@@ -25,3 +26,38 @@ void AShooterBot::FaceRotation(FRotator NewRotation, float DeltaTime)
 
 	Super::FaceRotation(CurrentRotation, DeltaTime);
 }
+
+void AShooterBot::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// listen servers and standalone games render the bots, reduced rates would show
+	if (GetLocalRole() == ROLE_Authority && GetNetMode() == NM_DedicatedServer)
+	{
+		if (UShooterBotMovementLODSubsystem* MovementLOD = GetWorld()->GetSubsystem<UShooterBotMovementLODSubsystem>())
+		{
+			MovementLOD->Register(this);
+		}
+	}
+}
+
+void AShooterBot::OnDeath(float KillingDamage, struct FDamageEvent const& DamageEvent, class APawn* InstigatingPawn, class AActor* DamageCauser)
+{
+	// back at full rate with the bot's own settings before UpdatePawnMeshes changes them under the subsystem
+	if (UShooterBotMovementLODSubsystem* MovementLOD = GetWorld()->GetSubsystem<UShooterBotMovementLODSubsystem>())
+	{
+		MovementLOD->Unregister(this);
+	}
+
+	Super::OnDeath(KillingDamage, DamageEvent, InstigatingPawn, DamageCauser);
+}
+
+void AShooterBot::Destroyed()
+{
+	Super::Destroyed();
+
+	if (UShooterBotMovementLODSubsystem* MovementLOD = GetWorld()->GetSubsystem<UShooterBotMovementLODSubsystem>())
+	{
+		MovementLOD->Unregister(this);
+	}
+}
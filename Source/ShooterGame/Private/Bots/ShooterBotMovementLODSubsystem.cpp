@@ -0,0 +1,201 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Bots/ShooterBotMovementLODSubsystem.h"
+#include "Bots/ShooterBot.h"
+
+static int32 BotMovementLOD = 1;
+FAutoConsoleVariableRef CVarBotMovementLOD(
+	TEXT("p.BotMovementLOD"),
+	BotMovementLOD,
+	TEXT("Tick movement and mesh of bots out of every player's relevancy range at a reduced rate.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static float BotMovementLODTickInterval = 0.1f;
+FAutoConsoleVariableRef CVarBotMovementLODTickInterval(
+	TEXT("p.BotMovementLODTickInterval"),
+	BotMovementLODTickInterval,
+	TEXT("Seconds between movement ticks of bots at reduced rate."),
+	ECVF_Default);
+
+static float BotMovementLODMaxTimeStep = 0.1f;
+FAutoConsoleVariableRef CVarBotMovementLODMaxTimeStep(
+	TEXT("p.BotMovementLODMaxTimeStep"),
+	BotMovementLODMaxTimeStep,
+	TEXT("Longest movement sub-step of bots at reduced rate."),
+	ECVF_Default);
+
+static float BotMovementLODUpdateInterval = 0.25f;
+FAutoConsoleVariableRef CVarBotMovementLODUpdateInterval(
+	TEXT("p.BotMovementLODUpdateInterval"),
+	BotMovementLODUpdateInterval,
+	TEXT("Seconds between checks of which bots are near a player."),
+	ECVF_Default);
+
+static float BotMovementLODClosingSpeed = 3000.f;
+FAutoConsoleVariableRef CVarBotMovementLODClosingSpeed(
+	TEXT("p.BotMovementLODClosingSpeed"),
+	BotMovementLODClosingSpeed,
+	TEXT("Fastest a player and a bot close in on each other. Bots come back to full rate this speed times p.BotMovementLODUpdateInterval outside their net cull distance."),
+	ECVF_Default);
+
+DECLARE_CYCLE_STAT(TEXT("Bot Movement LOD Update"), STAT_ShooterBotMovementLODUpdate, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Bots At Reduced Rate"), STAT_ShooterBotsReduced, STATGROUP_Game);
+
+/** full rate bots only go back to reduced rate past this much of the distance reduced ones come back at */
+static const float BotMovementLODHysteresis = 1.1f;
+
+void UShooterBotMovementLODSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_ShooterBotsReduced, NumReducedBots);
+	NumReducedBots = 0;
+	TrackedBots.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UShooterBotMovementLODSubsystem::IsTickable() const
+{
+	return TrackedBots.Num() > 0 && !IsTemplate();
+}
+
+TStatId UShooterBotMovementLODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterBotMovementLODSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterBotMovementLODSubsystem::Register(AShooterBot* Bot)
+{
+	if (Bot == nullptr || TrackedBots.ContainsByPredicate([Bot](const FTrackedBot& Tracked) { return Tracked.Bot == Bot; }))
+	{
+		return;
+	}
+
+	FTrackedBot& Tracked = TrackedBots.AddDefaulted_GetRef();
+	Tracked.Bot = Bot;
+}
+
+void UShooterBotMovementLODSubsystem::Unregister(AShooterBot* Bot)
+{
+	const int32 Index = TrackedBots.IndexOfByPredicate([Bot](const FTrackedBot& Tracked) { return Tracked.Bot == Bot; });
+	if (Index != INDEX_NONE)
+	{
+		SetReduced(TrackedBots[Index], false);
+		TrackedBots.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void UShooterBotMovementLODSubsystem::Tick(float DeltaTime)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (LastUpdateTime >= 0.0f && Now - LastUpdateTime < BotMovementLODUpdateInterval)
+	{
+		return;
+	}
+	LastUpdateTime = Now;
+
+	SCOPE_CYCLE_COUNTER(STAT_ShooterBotMovementLODUpdate);
+
+	// what each player sees from, spectators included
+	TArray<FVector, TInlineAllocator<16>> ViewLocations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		const AActor* ViewTarget = PC ? PC->GetViewTarget() : nullptr;
+		if (ViewTarget)
+		{
+			ViewLocations.Add(ViewTarget->GetActorLocation());
+		}
+	}
+
+	for (int32 Idx = TrackedBots.Num() - 1; Idx >= 0; --Idx)
+	{
+		FTrackedBot& Tracked = TrackedBots[Idx];
+
+		const AShooterBot* Bot = Tracked.Bot.Get();
+		if (Bot == nullptr)
+		{
+			if (Tracked.bReduced)
+			{
+				--NumReducedBots;
+				DEC_DWORD_STAT(STAT_ShooterBotsReduced);
+			}
+			TrackedBots.RemoveAtSwap(Idx, 1, false);
+			continue;
+		}
+
+		bool bReduced = false;
+		if (BotMovementLOD)
+		{
+			// back to full rate before the bot can become relevant: it may close in for a whole update interval before the next check
+			const float RestoreRange = FMath::Sqrt(Bot->NetCullDistanceSquared) + BotMovementLODUpdateInterval * BotMovementLODClosingSpeed;
+			const float RangeSq = FMath::Square(RestoreRange * (Tracked.bReduced ? 1.0f : BotMovementLODHysteresis));
+			const FVector BotLocation = Bot->GetActorLocation();
+
+			bReduced = true;
+			for (const FVector& ViewLocation : ViewLocations)
+			{
+				if (FVector::DistSquared(ViewLocation, BotLocation) < RangeSq)
+				{
+					bReduced = false;
+					break;
+				}
+			}
+		}
+
+		SetReduced(Tracked, bReduced);
+	}
+}
+
+void UShooterBotMovementLODSubsystem::SetReduced(FTrackedBot& Tracked, bool bReduced)
+{
+	AShooterBot* Bot = Tracked.Bot.Get();
+	if (Bot == nullptr || Tracked.bReduced == bReduced)
+	{
+		return;
+	}
+
+	UCharacterMovementComponent* Movement = Bot->GetCharacterMovement();
+	USkeletalMeshComponent* Mesh = Bot->GetMesh();
+
+	if (bReduced)
+	{
+		if (Movement)
+		{
+			Tracked.MovementTickInterval = Movement->GetComponentTickInterval();
+			Tracked.MaxSimulationTimeStep = Movement->MaxSimulationTimeStep;
+
+			Movement->SetComponentTickInterval(BotMovementLODTickInterval);
+			Movement->MaxSimulationTimeStep = FMath::Max(Movement->MaxSimulationTimeStep, BotMovementLODMaxTimeStep);
+		}
+
+		// nothing renders on a dedicated server, so only montages advance
+		if (Mesh)
+		{
+			Tracked.MeshAnimTickOption = Mesh->VisibilityBasedAnimTickOption;
+			Mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+		}
+
+		++NumReducedBots;
+		INC_DWORD_STAT(STAT_ShooterBotsReduced);
+	}
+	else
+	{
+		if (Movement)
+		{
+			Movement->SetComponentTickInterval(Tracked.MovementTickInterval);
+			Movement->MaxSimulationTimeStep = Tracked.MaxSimulationTimeStep;
+		}
+
+		if (Mesh)
+		{
+			Mesh->VisibilityBasedAnimTickOption = Tracked.MeshAnimTickOption;
+		}
+
+		--NumReducedBots;
+		DEC_DWORD_STAT(STAT_ShooterBotsReduced);
+	}
+
+	Tracked.bReduced = bReduced;
+}
@@ -0,0 +1,294 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Effects/ShooterEffectsSubsystem.h"
+#include "Effects/ShooterImpactEffect.h"
+#include "Effects/ShooterExplosionEffect.h"
+
+static int32 EffectsMaxPerFrame = 8;
+FAutoConsoleVariableRef CVarEffectsMaxPerFrame(
+	TEXT("p.EffectsMaxPerFrame"),
+	EffectsMaxPerFrame,
+	TEXT("Most impact and explosion effects started per frame, the ones past it only play their sound."),
+	ECVF_Default);
+
+static int32 EffectsMaxActive = 32;
+FAutoConsoleVariableRef CVarEffectsMaxActive(
+	TEXT("p.EffectsMaxActive"),
+	EffectsMaxActive,
+	TEXT("Most impact and explosion effects playing at once, the ones past it only play their sound."),
+	ECVF_Default);
+
+static float EffectsCullDistance = 10000.0f;
+FAutoConsoleVariableRef CVarEffectsCullDistance(
+	TEXT("p.EffectsCullDistance"),
+	EffectsCullDistance,
+	TEXT("Impact and explosion effects further than this from every local view are skipped."),
+	ECVF_Default);
+
+static int32 EffectsViewCulling = 1;
+FAutoConsoleVariableRef CVarEffectsViewCulling(
+	TEXT("p.EffectsViewCulling"),
+	EffectsViewCulling,
+	TEXT("Only play the sound of impact and explosion effects outside every local view.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static int32 EffectPoolSize = 8;
+FAutoConsoleVariableRef CVarEffectPoolSize(
+	TEXT("p.EffectPoolSize"),
+	EffectPoolSize,
+	TEXT("Most free effect actors kept per class, 0 destroys them once they are done."),
+	ECVF_Default);
+
+DECLARE_CYCLE_STAT(TEXT("Effects Update"), STAT_ShooterEffectsUpdate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effects Spawned"), STAT_ShooterEffectsSpawned, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effects Reused"), STAT_ShooterEffectsReused, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Effects Culled"), STAT_ShooterEffectsCulled, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effects Active"), STAT_ShooterEffectsActive, STATGROUP_Game);
+
+/** effects this close to a view are played even when behind it */
+static const float EffectsViewCullMinDistance = 500.0f;
+
+/** effects are taken back after this even when their particles still play, e.g. looping ones */
+static const float EffectMaxLifetime = 10.0f;
+
+void UShooterEffectsSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_ShooterEffectsActive, ActiveEffects.Num());
+	ActiveEffects.Reset();
+	FreeEffects.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UShooterEffectsSubsystem::IsTickable() const
+{
+	return ActiveEffects.Num() > 0 && !IsTemplate();
+}
+
+TStatId UShooterEffectsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterEffectsSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterEffectsSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterEffectsUpdate);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	for (int32 Idx = ActiveEffects.Num() - 1; Idx >= 0; --Idx)
+	{
+		FActiveEffect& Active = ActiveEffects[Idx];
+
+		if (Active.bLightOn)
+		{
+			AShooterExplosionEffect* Explosion = Active.Explosion.Get();
+			Active.bLightOn = Explosion && Explosion->UpdateLight(Now - Active.StartTime);
+		}
+
+		// particles go inactive once they complete
+		UParticleSystemComponent* Particles = Active.Particles.Get();
+		const bool bPlaying = (Active.bLightOn || (Particles && Particles->IsActive())) && Now - Active.StartTime < EffectMaxLifetime;
+
+		AActor* Effect = Active.Effect.Get();
+		if (!bPlaying || Effect == nullptr)
+		{
+			if (Particles)
+			{
+				Particles->DeactivateSystem();
+			}
+
+			if (Effect)
+			{
+				ReleaseEffect(Effect);
+			}
+
+			ActiveEffects.RemoveAtSwap(Idx, 1, false);
+			DEC_DWORD_STAT(STAT_ShooterEffectsActive);
+		}
+	}
+}
+
+void UShooterEffectsSubsystem::SpawnImpactEffect(TSubclassOf<AShooterImpactEffect> Class, const FTransform& SpawnTransform, const FHitResult& SurfaceHit)
+{
+	if (Class == nullptr)
+	{
+		return;
+	}
+
+	const EEffectDetail Detail = GetEffectDetail(SpawnTransform.GetLocation());
+	if (Detail == EEffectDetail::SoundOnly)
+	{
+		const AShooterImpactEffect* DefaultEffect = Class->GetDefaultObject<AShooterImpactEffect>();
+		USoundCue* ImpactSound = DefaultEffect->GetImpactSound(UPhysicalMaterial::DetermineSurfaceType(SurfaceHit.PhysMaterial.Get()));
+		if (ImpactSound)
+		{
+			UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, SpawnTransform.GetLocation());
+		}
+	}
+	else if (Detail == EEffectDetail::Full)
+	{
+		AShooterImpactEffect* Effect = AcquireEffect<AShooterImpactEffect>(Class, SpawnTransform);
+		if (Effect)
+		{
+			Effect->SurfaceHit = SurfaceHit;
+
+			FActiveEffect& Active = ActiveEffects.AddDefaulted_GetRef();
+			Active.Effect = Effect;
+			Active.Particles = Effect->PlayEffect();
+			Active.StartTime = GetWorld()->GetTimeSeconds();
+			Active.bLightOn = false;
+			INC_DWORD_STAT(STAT_ShooterEffectsActive);
+		}
+	}
+}
+
+void UShooterEffectsSubsystem::SpawnExplosionEffect(TSubclassOf<AShooterExplosionEffect> Class, const FTransform& SpawnTransform, const FHitResult& SurfaceHit)
+{
+	if (Class == nullptr)
+	{
+		return;
+	}
+
+	const EEffectDetail Detail = GetEffectDetail(SpawnTransform.GetLocation());
+	if (Detail == EEffectDetail::SoundOnly)
+	{
+		USoundCue* ExplosionSound = Class->GetDefaultObject<AShooterExplosionEffect>()->ExplosionSound;
+		if (ExplosionSound)
+		{
+			UGameplayStatics::PlaySoundAtLocation(this, ExplosionSound, SpawnTransform.GetLocation());
+		}
+	}
+	else if (Detail == EEffectDetail::Full)
+	{
+		AShooterExplosionEffect* Effect = AcquireEffect<AShooterExplosionEffect>(Class, SpawnTransform);
+		if (Effect)
+		{
+			Effect->SurfaceHit = SurfaceHit;
+
+			FActiveEffect& Active = ActiveEffects.AddDefaulted_GetRef();
+			Active.Effect = Effect;
+			Active.Explosion = Effect;
+			Active.Particles = Effect->PlayEffect();
+			Active.StartTime = GetWorld()->GetTimeSeconds();
+			Active.bLightOn = true;
+			INC_DWORD_STAT(STAT_ShooterEffectsActive);
+		}
+	}
+}
+
+UShooterEffectsSubsystem::EEffectDetail UShooterEffectsSubsystem::GetEffectDetail(const FVector& Location)
+{
+	UWorld* World = GetWorld();
+
+	// nobody to show them to
+	if (World->GetNetMode() == NM_DedicatedServer)
+	{
+		return EEffectDetail::None;
+	}
+
+	bool bHasView = false;
+	bool bInRange = false;
+	bool bInView = false;
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC == nullptr || !PC->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		bHasView = true;
+
+		const FVector ToEffect = Location - ViewLocation;
+		const float DistanceSq = ToEffect.SizeSquared();
+		if (DistanceSq > FMath::Square(EffectsCullDistance))
+		{
+			continue;
+		}
+		bInRange = true;
+
+		// half the horizontal FOV with some slack covers the screen's corners and particles reaching into it
+		const float FOVAngle = PC->PlayerCameraManager ? PC->PlayerCameraManager->GetFOVAngle() : 90.0f;
+		const float CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(FMath::Min(FOVAngle * 0.5f + 15.0f, 180.0f)));
+
+		if (!EffectsViewCulling || DistanceSq < FMath::Square(EffectsViewCullMinDistance) ||
+			(ToEffect.GetSafeNormal() | ViewRotation.Vector()) >= CosHalfFOV)
+		{
+			bInView = true;
+			break;
+		}
+	}
+
+	if (bHasView && !bInRange)
+	{
+		INC_DWORD_STAT(STAT_ShooterEffectsCulled);
+		return EEffectDetail::None;
+	}
+
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		NumEffectsThisFrame = 0;
+	}
+
+	if ((bHasView && !bInView) || NumEffectsThisFrame >= EffectsMaxPerFrame || ActiveEffects.Num() >= EffectsMaxActive)
+	{
+		INC_DWORD_STAT(STAT_ShooterEffectsCulled);
+		return EEffectDetail::SoundOnly;
+	}
+
+	++NumEffectsThisFrame;
+	return EEffectDetail::Full;
+}
+
+template<typename T>
+T* UShooterEffectsSubsystem::AcquireEffect(TSubclassOf<T> Class, const FTransform& SpawnTransform)
+{
+	if (TArray<TWeakObjectPtr<AActor>>* Pool = FreeEffects.Find(Class.Get()))
+	{
+		while (Pool->Num() > 0)
+		{
+			T* Effect = Cast<T>(Pool->Pop(false).Get());
+
+			// destroyed while in the pool, e.g. by a level reset
+			if (Effect && !Effect->IsPendingKillPending())
+			{
+				Effect->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::TeleportPhysics);
+
+				INC_DWORD_STAT(STAT_ShooterEffectsReused);
+				return Effect;
+			}
+		}
+	}
+
+	T* Effect = GetWorld()->SpawnActorDeferred<T>(Class, SpawnTransform);
+	if (Effect)
+	{
+		Effect->bManaged = true;
+		UGameplayStatics::FinishSpawningActor(Effect, SpawnTransform);
+
+		INC_DWORD_STAT(STAT_ShooterEffectsSpawned);
+	}
+
+	return Effect;
+}
+
+void UShooterEffectsSubsystem::ReleaseEffect(AActor* Effect)
+{
+	TArray<TWeakObjectPtr<AActor>>& Pool = FreeEffects.FindOrAdd(Effect->GetClass());
+	if (Pool.Num() >= EffectPoolSize)
+	{
+		Effect->Destroy();
+		return;
+	}
+
+	// not hidden, its decal stays up until its life span is over or the effect is reused
+	Pool.Add(Effect);
+}
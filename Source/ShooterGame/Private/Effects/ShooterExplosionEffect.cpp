@@ -18,16 +18,53 @@ AShooterExplosionEffect::AShooterExplosionEffect(const FObjectInitializer& Objec
 	ExplosionLight->CastShadows = false;
 	ExplosionLight->SetVisibleFlag(true);
 
+	ExplosionParticles = ObjectInitializer.CreateDefaultSubobject<UParticleSystemComponent>(this, TEXT("ExplosionParticles"));
+	ExplosionParticles->SetupAttachment(RootComponent);
+	ExplosionParticles->bAutoActivate = false;
+	ExplosionParticles->bAutoDestroy = false;
+
+	ExplosionDecal = ObjectInitializer.CreateDefaultSubobject<UDecalComponent>(this, TEXT("ExplosionDecal"));
+	ExplosionDecal->SetupAttachment(RootComponent);
+	ExplosionDecal->SetVisibleFlag(false);
+
 	ExplosionLightFadeOut = 0.2f;
+	ExplosionLightIntensity = ExplosionLight->Intensity;
+	bManaged = false;
 }
 
 void AShooterExplosionEffect::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if (ExplosionFX)
+	ExplosionLightIntensity = ExplosionLight->Intensity;
+
+	if (bManaged)
+	{
+		// faded by the effects subsystem
+		SetActorTickEnabled(false);
+	}
+	else
+	{
+		PlayEffect();
+	}
+}
+
+UParticleSystemComponent* AShooterExplosionEffect::PlayEffect()
+{
+	ExplosionLight->SetVisibility(true);
+	UpdateLight(0.0f);
+
+	// managed effects restart their own particles instead of spawning new ones
+	UParticleSystemComponent* ExplosionPSC = NULL;
+	if (ExplosionFX && bManaged)
+	{
+		ExplosionParticles->SetTemplate(ExplosionFX);
+		ExplosionParticles->ActivateSystem(true);
+		ExplosionPSC = ExplosionParticles;
+	}
+	else if (ExplosionFX)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(this, ExplosionFX, GetActorLocation(), GetActorRotation());
+		ExplosionPSC = UGameplayStatics::SpawnEmitterAtLocation(this, ExplosionFX, GetActorLocation(), GetActorRotation());
 	}
 
 	if (ExplosionSound)
@@ -35,7 +72,29 @@ void AShooterExplosionEffect::BeginPlay()
 		UGameplayStatics::PlaySoundAtLocation(this, ExplosionSound, GetActorLocation());
 	}
 
-	if (Decal.DecalMaterial)
+	if (Decal.DecalMaterial && bManaged)
+	{
+		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
+		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
+
+		// moves the decal off the previous surface, it outlives the light and particles until this effect is reused
+		USceneComponent* AttachTo = SurfaceHit.Component.IsValid() ? SurfaceHit.Component.Get() : RootComponent;
+		ExplosionDecal->AttachToComponent(AttachTo, FAttachmentTransformRules::KeepWorldTransform, SurfaceHit.BoneName);
+		ExplosionDecal->SetWorldLocationAndRotation(SurfaceHit.ImpactPoint, RandomDecalRotation);
+		ExplosionDecal->DecalSize = FVector(Decal.DecalSize, Decal.DecalSize, 1.0f);
+		ExplosionDecal->SetDecalMaterial(Decal.DecalMaterial);
+		ExplosionDecal->SetVisibility(true);
+
+		if (Decal.LifeSpan > 0.0f)
+		{
+			GetWorldTimerManager().SetTimer(TimerHandle_HideDecal, this, &AShooterExplosionEffect::HideDecal, Decal.LifeSpan, false);
+		}
+		else
+		{
+			GetWorldTimerManager().ClearTimer(TimerHandle_HideDecal);
+		}
+	}
+	else if (Decal.DecalMaterial)
 	{
 		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
 		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
@@ -45,24 +104,36 @@ void AShooterExplosionEffect::BeginPlay()
 			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
 			Decal.LifeSpan);
 	}
+
+	return ExplosionPSC;
+}
+
+void AShooterExplosionEffect::HideDecal()
+{
+	ExplosionDecal->SetVisibility(false);
 }
 
 void AShooterExplosionEffect::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
-	const float TimeAlive = GetWorld()->GetTimeSeconds() - CreationTime;
+	if (!UpdateLight(GetWorld()->GetTimeSeconds() - CreationTime))
+	{
+		Destroy();
+	}
+}
+
+bool AShooterExplosionEffect::UpdateLight(float TimeAlive)
+{
 	const float TimeRemaining = FMath::Max(0.0f, ExplosionLightFadeOut - TimeAlive);
 
 	if (TimeRemaining > 0)
 	{
 		const float FadeAlpha = 1.0f - FMath::Square(TimeRemaining / ExplosionLightFadeOut);
-
-		UPointLightComponent* DefLight = Cast<UPointLightComponent>(GetClass()->GetDefaultSubobjectByName(ExplosionLightComponentName));
-		ExplosionLight->SetIntensity(DefLight->Intensity * FadeAlpha);
-	}
-	else
-	{
-		Destroy();
+		ExplosionLight->SetIntensity(ExplosionLightIntensity * FadeAlpha);
+		return true;
 	}
+
+	ExplosionLight->SetVisibility(false);
+	return false;
 }
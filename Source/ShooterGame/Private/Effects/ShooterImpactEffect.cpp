@@ -5,21 +5,50 @@
 
 AShooterImpactEffect::AShooterImpactEffect(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
+	ImpactParticles = ObjectInitializer.CreateDefaultSubobject<UParticleSystemComponent>(this, TEXT("ImpactParticles"));
+	RootComponent = ImpactParticles;
+	ImpactParticles->bAutoActivate = false;
+	ImpactParticles->bAutoDestroy = false;
+
+	ImpactDecal = ObjectInitializer.CreateDefaultSubobject<UDecalComponent>(this, TEXT("ImpactDecal"));
+	ImpactDecal->SetupAttachment(RootComponent);
+	ImpactDecal->SetVisibleFlag(false);
+
 	SetAutoDestroyWhenFinished(true);
+	bManaged = false;
 }
 
 void AShooterImpactEffect::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
+	if (bManaged)
+	{
+		SetAutoDestroyWhenFinished(false);
+	}
+	else
+	{
+		PlayEffect();
+	}
+}
+
+UParticleSystemComponent* AShooterImpactEffect::PlayEffect()
+{
 	UPhysicalMaterial* HitPhysMat = SurfaceHit.PhysMaterial.Get();
 	EPhysicalSurface HitSurfaceType = UPhysicalMaterial::DetermineSurfaceType(HitPhysMat);
 
-	// show particles
+	// show particles, managed effects restart their own instead of spawning new ones
+	UParticleSystemComponent* ImpactPSC = NULL;
 	UParticleSystem* ImpactFX = GetImpactFX(HitSurfaceType);
-	if (ImpactFX)
+	if (ImpactFX && bManaged)
+	{
+		ImpactParticles->SetTemplate(ImpactFX);
+		ImpactParticles->ActivateSystem(true);
+		ImpactPSC = ImpactParticles;
+	}
+	else if (ImpactFX)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(this, ImpactFX, GetActorLocation(), GetActorRotation());
+		ImpactPSC = UGameplayStatics::SpawnEmitterAtLocation(this, ImpactFX, GetActorLocation(), GetActorRotation());
 	}
 
 	// play sound
@@ -29,7 +58,29 @@ void AShooterImpactEffect::PostInitializeComponents()
 		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
 	}
 
-	if (DefaultDecal.DecalMaterial)
+	if (DefaultDecal.DecalMaterial && bManaged)
+	{
+		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
+		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
+
+		// moves the decal off the previous surface, it outlives the particles until this effect is reused
+		USceneComponent* AttachTo = SurfaceHit.Component.IsValid() ? SurfaceHit.Component.Get() : RootComponent;
+		ImpactDecal->AttachToComponent(AttachTo, FAttachmentTransformRules::KeepWorldTransform, SurfaceHit.BoneName);
+		ImpactDecal->SetWorldLocationAndRotation(SurfaceHit.ImpactPoint, RandomDecalRotation);
+		ImpactDecal->DecalSize = FVector(1.0f, DefaultDecal.DecalSize, DefaultDecal.DecalSize);
+		ImpactDecal->SetDecalMaterial(DefaultDecal.DecalMaterial);
+		ImpactDecal->SetVisibility(true);
+
+		if (DefaultDecal.LifeSpan > 0.0f)
+		{
+			GetWorldTimerManager().SetTimer(TimerHandle_HideDecal, this, &AShooterImpactEffect::HideDecal, DefaultDecal.LifeSpan, false);
+		}
+		else
+		{
+			GetWorldTimerManager().ClearTimer(TimerHandle_HideDecal);
+		}
+	}
+	else if (DefaultDecal.DecalMaterial)
 	{
 		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
 		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
@@ -39,6 +90,13 @@ void AShooterImpactEffect::PostInitializeComponents()
 			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
 			DefaultDecal.LifeSpan);
 	}
+
+	return ImpactPSC;
+}
+
+void AShooterImpactEffect::HideDecal()
+{
+	ImpactDecal->SetVisibility(false);
 }
 
 UParticleSystem* AShooterImpactEffect::GetImpactFX(TEnumAsByte<EPhysicalSurface> SurfaceType) const
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterActorChannel.h"
+#include "ShooterReplicationGraph.h"
+#include "Net/DataBunch.h"
+
+UShooterActorChannel::UShooterActorChannel(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+FPacketIdRange UShooterActorChannel::SendBunch(FOutBunch* Bunch, bool Merge)
+{
+	if (FShooterRepGraphTelemetry::IsEnabled() && Actor && Bunch && Connection && Connection->Driver)
+	{
+		// only the server has a replication graph
+		if (UShooterReplicationGraph* ShooterGraph = Cast<UShooterReplicationGraph>(Connection->Driver->GetReplicationDriver()))
+		{
+			ShooterGraph->Telemetry.RecordBunch(Actor->GetClass(), Bunch->GetNumBits());
+		}
+	}
+
+	return Super::SendBunch(Bunch, Merge);
+}
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/ActorChannel.h"
+#include "ShooterActorChannel.generated.h"
+
+/**
+ * Actor channel that counts the bunches it sends per actor class into UShooterReplicationGraph's telemetry.
+ * The graph only hands it to the net driver for actor channels opened while ShooterRepGraph.Telemetry is set, otherwise it behaves like the engine's.
+ */
+UCLASS(transient, customConstructor)
+class UShooterActorChannel : public UActorChannel
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterActorChannel(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	// Begin UChannel interface
+	virtual FPacketIdRange SendBunch(FOutBunch* Bunch, bool Merge) override;
+	// End UChannel interface
+};
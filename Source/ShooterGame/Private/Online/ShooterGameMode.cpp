@@ -10,6 +10,7 @@
 #include "Online/ShooterGameSession.h"
 #include "Bots/ShooterAIController.h"
 #include "ShooterTeamStart.h"
+#include "Pickups/ShooterPickup.h"
 
 
 AShooterGameMode::AShooterGameMode(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
@@ -31,6 +32,7 @@ AShooterGameMode::AShooterGameMode(const FObjectInitializer& ObjectInitializer)
 
 	bAllowBots = true;	
 	bNeedsBotCreation = true;
+	NumPickupsReplicated = 0;
 	bUseSeamlessTravel = FParse::Param(FCommandLine::Get(), TEXT("NoSeamlessTravel")) ? false : true;
 }
 
@@ -80,6 +82,15 @@ void AShooterGameMode::PreInitializeComponents()
 	GetWorldTimerManager().SetTimer(TimerHandle_DefaultTimer, this, &AShooterGameMode::DefaultTimer, GetWorldSettings()->GetEffectiveTimeDilation(), true);
 }
 
+void AShooterGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// replication runs after the actors tick, so these are last frame's numbers
+	AShooterPickup::UpdateReplicationStats(LevelPickups, NumPickupsReplicated);
+	NumPickupsReplicated = 0;
+}
+
 void AShooterGameMode::DefaultTimer()
 {
 	// don't update timers for Play In Editor mode, it's not real match
@@ -305,13 +316,17 @@ void AShooterGameMode::Killed(AController* Killer, AController* KilledPlayer, AP
 	if (KillerPlayerState && KillerPlayerState != VictimPlayerState)
 	{
 		KillerPlayerState->ScoreKill(VictimPlayerState, KillScore);
-		KillerPlayerState->InformAboutKill(KillerPlayerState, DamageType, VictimPlayerState);
 	}
 
 	if (VictimPlayerState)
 	{
 		VictimPlayerState->ScoreDeath(KillerPlayerState, DeathScore);
-		VictimPlayerState->BroadcastDeath(KillerPlayerState, DamageType, VictimPlayerState);
+
+		AShooterGameState* const MyGameState = GetGameState<AShooterGameState>();
+		if (MyGameState)
+		{
+			MyGameState->AddKill(KillerPlayerState, DamageType, VictimPlayerState);
+		}
 	}
 }
 
@@ -4,11 +4,34 @@
 #include "Online/ShooterPlayerState.h"
 #include "ShooterGameInstance.h"
 
+/** kills older than this are not announced, e.g. the ones already in the feed when joining */
+static const float KillFeedEntryLifetime = 5.0f;
+
+/** most kills kept in the feed */
+static const int32 MaxKillFeedEntries = 16;
+
+void FShooterKillFeedEntry::PostReplicatedAdd(const FShooterKillFeed& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnKillFeedEntryReceived(*this);
+	}
+}
+
+void FShooterKillFeedEntry::PostReplicatedChange(const FShooterKillFeed& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnKillFeedEntryReceived(*this);
+	}
+}
+
 AShooterGameState::AShooterGameState(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	NumTeams = 0;
 	RemainingTime = 0;
 	bTimerPaused = false;
+	KillFeed.Owner = this;
 }
 
 void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
@@ -19,6 +42,76 @@ void AShooterGameState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	DOREPLIFETIME( AShooterGameState, RemainingTime );
 	DOREPLIFETIME( AShooterGameState, bTimerPaused );
 	DOREPLIFETIME( AShooterGameState, TeamScores );
+	DOREPLIFETIME( AShooterGameState, KillFeed );
+}
+
+void AShooterGameState::AddKill(AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, AShooterPlayerState* KilledPlayerState)
+{
+	const float Now = GetServerWorldTimeSeconds();
+
+	const int32 NumExpired = KillFeed.Items.IndexOfByPredicate([Now](const FShooterKillFeedEntry& Entry) { return Now - Entry.Time <= KillFeedEntryLifetime; });
+	const int32 NumToRemove = FMath::Max(NumExpired == INDEX_NONE ? KillFeed.Items.Num() : NumExpired, KillFeed.Items.Num() - MaxKillFeedEntries + 1);
+	if (NumToRemove > 0)
+	{
+		KillFeed.Items.RemoveAt(0, NumToRemove);
+		KillFeed.MarkArrayDirty();
+	}
+
+	FShooterKillFeedEntry& Entry = KillFeed.Items.AddDefaulted_GetRef();
+	Entry.Killer = KillerPlayerState;
+	Entry.Victim = KilledPlayerState;
+	Entry.bHasKiller = KillerPlayerState != nullptr;
+	Entry.DamageType = KillerDamageType ? KillerDamageType->GetClass() : nullptr;
+	Entry.Time = Now;
+	Entry.bHandled = true;
+	KillFeed.MarkItemDirty(Entry);
+
+	// several kills in one frame still go out together, this only makes sure it's the next replication
+	ForceNetUpdate();
+
+	// listen server and standalone players don't get the replicated feed
+	NotifyLocalPlayersAboutKill(Entry);
+}
+
+void AShooterGameState::OnKillFeedEntryReceived(FShooterKillFeedEntry& Entry)
+{
+	// player states can arrive after the entry, PostReplicatedChange calls this again once they are mapped
+	if (Entry.bHandled || Entry.Victim == nullptr || (Entry.bHasKiller && Entry.Killer == nullptr))
+	{
+		return;
+	}
+
+	Entry.bHandled = true;
+
+	if (GetServerWorldTimeSeconds() - Entry.Time <= KillFeedEntryLifetime)
+	{
+		NotifyLocalPlayersAboutKill(Entry);
+	}
+}
+
+void AShooterGameState::NotifyLocalPlayersAboutKill(const FShooterKillFeedEntry& Entry)
+{
+	const UDamageType* KillerDamageType = Entry.DamageType ? Entry.DamageType->GetDefaultObject<UDamageType>() : nullptr;
+
+	//id can be null for bots
+	const bool bCheckKiller = Entry.Killer && Entry.Killer != Entry.Victim && Entry.Killer->GetUniqueId().IsValid();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		// all local players get death messages so they can update their huds.
+		AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
+		if (TestPC && TestPC->IsLocalController())
+		{
+			TestPC->OnDeathMessage(Entry.Killer, Entry.Victim, KillerDamageType);
+
+			// a local player might not have an ID if it was created with CreateDebugPlayer.
+			ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(TestPC->Player);
+			if (bCheckKiller && LocalPlayer && LocalPlayer->GetCachedUniqueNetId().IsValid() && *LocalPlayer->GetCachedUniqueNetId() == *Entry.Killer->GetUniqueId())
+			{
+				TestPC->OnKill();
+			}
+		}
+	}
 }
 
 void AShooterGameState::GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const
@@ -0,0 +1,299 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterLagCompensationSubsystem.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/BodySetup.h"
+
+static int32 LagCompensationEnabled = 1;
+FAutoConsoleVariableRef CVarLagCompensation(
+	TEXT("p.LagCompensation"),
+	LagCompensationEnabled,
+	TEXT("Validate client side hits against where the target was when the shooter fired.\n")
+	TEXT("0: Disable (bounding box check around the current location), 1: Enable"),
+	ECVF_Default);
+
+static float LagCompensationMaxRewind = 0.3f;
+FAutoConsoleVariableRef CVarLagCompensationMaxRewind(
+	TEXT("p.LagCompensationMaxRewind"),
+	LagCompensationMaxRewind,
+	TEXT("Most seconds hit validation rewinds, shooters with a higher ping have to lead their targets."),
+	ECVF_Default);
+
+static float LagCompensationInterpDelay = 0.05f;
+FAutoConsoleVariableRef CVarLagCompensationInterpDelay(
+	TEXT("p.LagCompensationInterpDelay"),
+	LagCompensationInterpDelay,
+	TEXT("Seconds simulated proxies are shown behind their replicated location on clients, added to the ping when rewinding."),
+	ECVF_Default);
+
+DECLARE_CYCLE_STAT(TEXT("LagCompensation Record"), STAT_ShooterLagCompensation_Record, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("LagCompensation Pawns"), STAT_ShooterLagCompensation_Pawns, STATGROUP_Game);
+
+//////////////////////////////////////////////////////////////////////////
+// FShooterHitboxHistory
+
+void FShooterHitboxHistory::Init(float InCapsuleRadius, float InCapsuleHalfHeight, TArrayView<const FName> InBones, TArrayView<const FBox> InLocalBoxes)
+{
+	check(InBones.Num() == InLocalBoxes.Num());
+
+	CapsuleRadius = InCapsuleRadius;
+	CapsuleHalfHeight = InCapsuleHalfHeight;
+
+	NumHitboxes = FMath::Min(InBones.Num(), MaxHitboxes);
+	for (int32 Idx = 0; Idx < NumHitboxes; ++Idx)
+	{
+		Bones[Idx] = InBones[Idx];
+		LocalBoxes[Idx] = InLocalBoxes[Idx];
+	}
+
+	Reset();
+}
+
+void FShooterHitboxHistory::Reset()
+{
+	NewestIndex = INDEX_NONE;
+	NumFrames = 0;
+}
+
+void FShooterHitboxHistory::Record(float Time, const FVector& CapsuleLocation, TArrayView<const FTransform> HitboxTransforms)
+{
+	// world time went back (new match, seamless travel), the old frames mean nothing now
+	if (NumFrames > 0 && Time < Frames[NewestIndex].Time)
+	{
+		Reset();
+	}
+
+	NewestIndex = (NewestIndex + 1) % MaxFrames;
+	NumFrames = FMath::Min(NumFrames + 1, MaxFrames);
+
+	FFrame& Frame = Frames[NewestIndex];
+	Frame.Time = Time;
+	Frame.CapsuleLocation = CapsuleLocation;
+
+	const int32 NumTransforms = FMath::Min(HitboxTransforms.Num(), NumHitboxes);
+	for (int32 Idx = 0; Idx < NumTransforms; ++Idx)
+	{
+		Frame.HitboxLocations[Idx] = HitboxTransforms[Idx].GetLocation();
+		Frame.HitboxRotations[Idx] = HitboxTransforms[Idx].GetRotation();
+	}
+}
+
+float FShooterHitboxHistory::GetOldestTime() const
+{
+	return NumFrames > 0 ? Frames[(NewestIndex - NumFrames + 1 + MaxFrames) % MaxFrames].Time : 0.f;
+}
+
+bool FShooterHitboxHistory::Sample(float Time, FFrame& OutFrame) const
+{
+	if (NumFrames == 0)
+	{
+		return false;
+	}
+
+	// walk back from the newest frame to the first one at or before Time
+	const FFrame* After = &Frames[NewestIndex];
+	if (Time >= After->Time)
+	{
+		OutFrame = *After;
+		return true;
+	}
+
+	for (int32 Step = 1; Step < NumFrames; ++Step)
+	{
+		const FFrame& Before = Frames[(NewestIndex - Step + MaxFrames) % MaxFrames];
+		if (Before.Time <= Time)
+		{
+			const float Alpha = After->Time > Before.Time ? (Time - Before.Time) / (After->Time - Before.Time) : 1.f;
+
+			OutFrame.Time = Time;
+			OutFrame.CapsuleLocation = FMath::Lerp(Before.CapsuleLocation, After->CapsuleLocation, Alpha);
+			for (int32 Idx = 0; Idx < NumHitboxes; ++Idx)
+			{
+				OutFrame.HitboxLocations[Idx] = FMath::Lerp(Before.HitboxLocations[Idx], After->HitboxLocations[Idx], Alpha);
+				OutFrame.HitboxRotations[Idx] = FQuat::FastLerp(Before.HitboxRotations[Idx], After->HitboxRotations[Idx], Alpha).GetNormalized();
+			}
+			return true;
+		}
+
+		After = &Before;
+	}
+
+	// older than the history
+	OutFrame = *After;
+	return true;
+}
+
+bool FShooterHitboxHistory::IsNearHitbox(const FFrame& Frame, int32 HitboxIndex, const FVector& Location, float LeewaySq) const
+{
+	const FVector LocalLocation = Frame.HitboxRotations[HitboxIndex].UnrotateVector(Location - Frame.HitboxLocations[HitboxIndex]);
+	return LocalBoxes[HitboxIndex].ComputeSquaredDistanceToPoint(LocalLocation) <= LeewaySq;
+}
+
+bool FShooterHitboxHistory::IsNear(float Time, const FVector& Location, FName BoneName, float Leeway) const
+{
+	FFrame Frame;
+	if (!Sample(Time, Frame))
+	{
+		return false;
+	}
+
+	Leeway = FMath::Max(Leeway, 0.f);
+	const float LeewaySq = FMath::Square(Leeway);
+
+	if (!BoneName.IsNone())
+	{
+		for (int32 Idx = 0; Idx < NumHitboxes; ++Idx)
+		{
+			if (Bones[Idx] == BoneName)
+			{
+				return IsNearHitbox(Frame, Idx, Location, LeewaySq);
+			}
+		}
+	}
+
+	for (int32 Idx = 0; Idx < NumHitboxes; ++Idx)
+	{
+		if (IsNearHitbox(Frame, Idx, Location, LeewaySq))
+		{
+			return true;
+		}
+	}
+
+	const FVector SegmentOffset(0.f, 0.f, FMath::Max(CapsuleHalfHeight - CapsuleRadius, 0.f));
+	const FVector ClosestOnAxis = FMath::ClosestPointOnSegment(Location, Frame.CapsuleLocation - SegmentOffset, Frame.CapsuleLocation + SegmentOffset);
+	return FVector::DistSquared(Location, ClosestOnAxis) <= FMath::Square(CapsuleRadius + Leeway);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UShooterLagCompensationSubsystem
+
+void UShooterLagCompensationSubsystem::Deinitialize()
+{
+	TrackedPawns.Reset();
+	FreeTrackedPawns.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UShooterLagCompensationSubsystem::IsTickable() const
+{
+	return LagCompensationEnabled && TrackedPawns.Num() > 0 && !IsTemplate();
+}
+
+TStatId UShooterLagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterLagCompensationSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterLagCompensation_Record);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	FTransform HitboxTransforms[FShooterHitboxHistory::MaxHitboxes];
+
+	for (auto It = TrackedPawns.CreateIterator(); It; ++It)
+	{
+		FTrackedPawn& Tracked = *It.Value();
+		AShooterCharacter* Pawn = Tracked.Pawn.Get();
+		if (Pawn == nullptr)
+		{
+			FreeTrackedPawns.Add(MoveTemp(It.Value()));
+			It.RemoveCurrent();
+			continue;
+		}
+
+		const int32 NumHitboxes = Tracked.History.GetNumHitboxes();
+		const USkeletalMeshComponent* Mesh = Pawn->GetMesh();
+		for (int32 Idx = 0; Idx < NumHitboxes; ++Idx)
+		{
+			HitboxTransforms[Idx] = Mesh->GetBoneTransform(Tracked.BoneIndices[Idx]);
+		}
+
+		Tracked.History.Record(Now, Pawn->GetActorLocation(), MakeArrayView(HitboxTransforms, NumHitboxes));
+	}
+
+	SET_DWORD_STAT(STAT_ShooterLagCompensation_Pawns, TrackedPawns.Num());
+}
+
+void UShooterLagCompensationSubsystem::Register(AShooterCharacter* Pawn)
+{
+	if (Pawn == nullptr || TrackedPawns.Contains(Pawn))
+	{
+		return;
+	}
+
+	TUniquePtr<FTrackedPawn> Tracked = FreeTrackedPawns.Num() > 0 ? FreeTrackedPawns.Pop(false) : MakeUnique<FTrackedPawn>();
+	Tracked->Pawn = Pawn;
+
+	// hitboxes are the bodies of the physics asset, the mesh collision weapon traces hit
+	FName Bones[FShooterHitboxHistory::MaxHitboxes];
+	FBox LocalBoxes[FShooterHitboxHistory::MaxHitboxes];
+	int32 NumHitboxes = 0;
+
+	const USkeletalMeshComponent* Mesh = Pawn->GetMesh();
+	const UPhysicsAsset* PhysicsAsset = Mesh ? Mesh->GetPhysicsAsset() : nullptr;
+	if (PhysicsAsset)
+	{
+		for (const USkeletalBodySetup* BodySetup : PhysicsAsset->SkeletalBodySetups)
+		{
+			if (NumHitboxes == FShooterHitboxHistory::MaxHitboxes)
+			{
+				UE_LOG(LogShooter, Verbose, TEXT("%s: only the first %d bodies of %s are lag compensated"), *GetNameSafe(Pawn), NumHitboxes, *GetNameSafe(PhysicsAsset));
+				break;
+			}
+
+			const int32 BoneIndex = BodySetup ? Mesh->GetBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+			if (BoneIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const FBox LocalBox = BodySetup->AggGeom.CalcAABB(FTransform::Identity);
+			if (LocalBox.IsValid)
+			{
+				Bones[NumHitboxes] = BodySetup->BoneName;
+				LocalBoxes[NumHitboxes] = LocalBox;
+				Tracked->BoneIndices[NumHitboxes] = BoneIndex;
+				NumHitboxes++;
+			}
+		}
+	}
+
+	const UCapsuleComponent* Capsule = Pawn->GetCapsuleComponent();
+	Tracked->History.Init(Capsule->GetScaledCapsuleRadius(), Capsule->GetScaledCapsuleHalfHeight(), MakeArrayView(Bones, NumHitboxes), MakeArrayView(LocalBoxes, NumHitboxes));
+
+	TrackedPawns.Add(Pawn, MoveTemp(Tracked));
+}
+
+void UShooterLagCompensationSubsystem::Unregister(AShooterCharacter* Pawn)
+{
+	TUniquePtr<FTrackedPawn> Tracked;
+	if (TrackedPawns.RemoveAndCopyValue(Pawn, Tracked))
+	{
+		Tracked->Pawn.Reset();
+		FreeTrackedPawns.Add(MoveTemp(Tracked));
+	}
+}
+
+const FShooterHitboxHistory* UShooterLagCompensationSubsystem::FindHistory(const AActor* Target) const
+{
+	if (!LagCompensationEnabled || Target == nullptr)
+	{
+		return nullptr;
+	}
+
+	const TUniquePtr<FTrackedPawn>* Tracked = TrackedPawns.Find(Target);
+	return Tracked && (*Tracked)->History.GetNumFrames() > 0 ? &(*Tracked)->History : nullptr;
+}
+
+float UShooterLagCompensationSubsystem::GetClientTime(const AController* Shooter) const
+{
+	// ExactPing is the round trip: the shooter saw the world half of it ago, and the shot took the other half to get here
+	const APlayerState* ShooterPlayerState = Shooter ? Shooter->PlayerState : nullptr;
+	const float Ping = ShooterPlayerState ? ShooterPlayerState->ExactPing * 0.001f : 0.f;
+
+	const float Rewind = FMath::Clamp(Ping + LagCompensationInterpDelay, 0.f, FMath::Max(LagCompensationMaxRewind, 0.f));
+	return GetWorld()->GetTimeSeconds() - Rewind;
+}
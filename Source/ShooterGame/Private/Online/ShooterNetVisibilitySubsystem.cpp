@@ -0,0 +1,157 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterNetVisibilitySubsystem.h"
+
+static int32 NetPauseRelevancyCacheFrames = 4;
+FAutoConsoleVariableRef CVarNetPauseRelevancyCacheFrames(
+	TEXT("p.NetPauseRelevancyCacheFrames"),
+	NetPauseRelevancyCacheFrames,
+	TEXT("Number of frames a pause relevancy visibility result is reused before it is traced again."),
+	ECVF_Default);
+
+static float NetPauseRelevancyMoveThreshold = 25.f;
+FAutoConsoleVariableRef CVarNetPauseRelevancyMoveThreshold(
+	TEXT("p.NetPauseRelevancyMoveThreshold"),
+	NetPauseRelevancyMoveThreshold,
+	TEXT("Distance the viewer or the target has to move before an expired pause relevancy visibility result is traced again."),
+	ECVF_Default);
+
+static int32 NetPauseRelevancyPruneFrames = 120;
+FAutoConsoleVariableRef CVarNetPauseRelevancyPruneFrames(
+	TEXT("p.NetPauseRelevancyPruneFrames"),
+	NetPauseRelevancyPruneFrames,
+	TEXT("Cached pause relevancy results not queried for this many frames are discarded."),
+	ECVF_Default);
+
+DECLARE_CYCLE_STAT(TEXT("NetVisibility Tick"), STAT_ShooterNetVisibility_Tick, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("NetVisibility Queries"), STAT_ShooterNetVisibility_Queries, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("NetVisibility Async Traces"), STAT_ShooterNetVisibility_Traces, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("NetVisibility Cached Pairs"), STAT_ShooterNetVisibility_Pairs, STATGROUP_Game);
+
+void UShooterNetVisibilitySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceDelegate.BindUObject(this, &UShooterNetVisibilitySubsystem::OnTraceCompleted);
+}
+
+void UShooterNetVisibilitySubsystem::Deinitialize()
+{
+	TraceDelegate.Unbind();
+	EntryIndices.Reset();
+	Entries.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UShooterNetVisibilitySubsystem::IsTickable() const
+{
+	return Entries.Num() > 0 && !IsTemplate();
+}
+
+TStatId UShooterNetVisibilitySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterNetVisibilitySubsystem, STATGROUP_Tickables);
+}
+
+void UShooterNetVisibilitySubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterNetVisibility_Tick);
+
+	// Only sweep once in a while, entries are small and departed viewers/targets are rare
+	const uint64 PruneFrames = (uint64)FMath::Max(NetPauseRelevancyPruneFrames, 1);
+	if ((GFrameCounter % PruneFrames) != 0)
+	{
+		return;
+	}
+
+	for (auto It = EntryIndices.CreateIterator(); It; ++It)
+	{
+		const FVisibilityEntry& Entry = Entries[It.Value()];
+		if (Entry.PendingTraces == 0 && GFrameCounter - Entry.QueryFrame > PruneFrames)
+		{
+			Entries.RemoveAt(It.Value());
+			It.RemoveCurrent();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterNetVisibility_Pairs, Entries.Num());
+}
+
+bool UShooterNetVisibilitySubsystem::IsVisibleTo(const APlayerController* Viewer, const AActor* Target, const FVector& ViewLocation, TArrayView<const FVector> TestPoints)
+{
+	INC_DWORD_STAT(STAT_ShooterNetVisibility_Queries);
+
+	const uint64 PairKey = MakePairKey(Viewer, Target);
+	int32* IndexPtr = EntryIndices.Find(PairKey);
+	if (IndexPtr == nullptr)
+	{
+		IndexPtr = &EntryIndices.Add(PairKey, Entries.Add(FVisibilityEntry()));
+		INC_DWORD_STAT(STAT_ShooterNetVisibility_Pairs);
+	}
+
+	const int32 EntryIndex = *IndexPtr;
+	FVisibilityEntry& Entry = Entries[EntryIndex];
+	Entry.QueryFrame = GFrameCounter;
+
+	const FVector TargetLocation = Target->GetActorLocation();
+	const bool bNeverTested = (Entry.TestFrame == 0);
+
+	// Previous batch still in flight or result still fresh: use what we have
+	if (Entry.PendingTraces > 0 || (!bNeverTested && GFrameCounter - Entry.TestFrame < (uint64)NetPauseRelevancyCacheFrames))
+	{
+		return Entry.bVisible;
+	}
+
+	// Expired, but neither end moved enough to change the answer
+	const float MoveThresholdSq = FMath::Square(NetPauseRelevancyMoveThreshold);
+	if (!bNeverTested && FVector::DistSquared(Entry.ViewLocation, ViewLocation) < MoveThresholdSq && FVector::DistSquared(Entry.TargetLocation, TargetLocation) < MoveThresholdSq)
+	{
+		Entry.TestFrame = GFrameCounter;
+		return Entry.bVisible;
+	}
+
+	UWorld* World = GetWorld();
+
+	FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(LineOfSight), true, Viewer->GetPawn());
+	CollisionParams.AddIgnoredActor(Target);
+
+	Entry.ViewLocation = ViewLocation;
+	Entry.TargetLocation = TargetLocation;
+	Entry.TestFrame = GFrameCounter;
+	Entry.bPendingVisible = false;
+
+	for (const FVector& PointToTest : TestPoints)
+	{
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Test, PointToTest, ViewLocation, ECC_Visibility, CollisionParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, (uint32)EntryIndex);
+		Entry.PendingTraces++;
+	}
+
+	INC_DWORD_STAT_BY(STAT_ShooterNetVisibility_Traces, TestPoints.Num());
+
+	return Entry.bVisible;
+}
+
+void UShooterNetVisibilitySubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	const int32 EntryIndex = (int32)Datum.UserData;
+	if (!Entries.IsValidIndex(EntryIndex))
+	{
+		return;
+	}
+
+	FVisibilityEntry& Entry = Entries[EntryIndex];
+
+	const bool bBlocked = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+	if (!bBlocked)
+	{
+		Entry.bPendingVisible = true;
+	}
+
+	if (--Entry.PendingTraces <= 0)
+	{
+		Entry.PendingTraces = 0;
+		Entry.bVisible = Entry.bPendingVisible;
+	}
+}
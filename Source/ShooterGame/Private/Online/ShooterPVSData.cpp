@@ -0,0 +1,205 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterPVSData.h"
+#include "Engine/LevelBounds.h"
+#include "Misc/PackageName.h"
+
+/** tables above this many cells take too long to bake and too much memory to keep around (NumCells^2 bits) */
+static const int32 MaxPVSCells = 8192;
+
+int32 UShooterPVSData::GetCellIndex(const FVector& Location) const
+{
+	if (CellSize <= 0.f)
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector Local = (Location - Origin) / CellSize;
+	const int32 X = FMath::FloorToInt(Local.X);
+	const int32 Y = FMath::FloorToInt(Local.Y);
+	const int32 Z = FMath::FloorToInt(Local.Z);
+
+	if (X < 0 || Y < 0 || Z < 0 || X >= NumCells.X || Y >= NumCells.Y || Z >= NumCells.Z)
+	{
+		return INDEX_NONE;
+	}
+
+	return (Z * NumCells.Y + Y) * NumCells.X + X;
+}
+
+FBox UShooterPVSData::GetCellBounds(int32 CellIndex) const
+{
+	const int32 X = CellIndex % NumCells.X;
+	const int32 Y = (CellIndex / NumCells.X) % NumCells.Y;
+	const int32 Z = CellIndex / (NumCells.X * NumCells.Y);
+
+	const FVector Min = Origin + FVector(X, Y, Z) * CellSize;
+	return FBox(Min, Min + FVector(CellSize));
+}
+
+bool UShooterPVSData::IsVisible(const FVector& From, const FVector& To) const
+{
+	if (!IsValid())
+	{
+		return true;
+	}
+
+	const int32 FromCell = GetCellIndex(From);
+	const int32 ToCell = GetCellIndex(To);
+	if (FromCell == INDEX_NONE || ToCell == INDEX_NONE)
+	{
+		return true;
+	}
+
+	return IsCellVisible(FromCell, ToCell);
+}
+
+void UShooterPVSData::Build(UWorld* World, float InCellSize, int32 SamplesPerCell, float MaxTraceDistance)
+{
+	check(World);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FBox WorldBounds(ForceInit);
+	for (ULevel* Level : World->GetLevels())
+	{
+		if (Level && Level->bIsVisible)
+		{
+			WorldBounds += ALevelBounds::CalculateLevelBounds(Level);
+		}
+	}
+
+	Origin = FVector::ZeroVector;
+	CellSize = 0.f;
+	NumCells = FIntVector::ZeroValue;
+	VisibilityBits.Reset();
+
+	if (!WorldBounds.IsValid || InCellSize <= 0.f)
+	{
+		UE_LOG(LogShooter, Error, TEXT("UShooterPVSData::Build - no level bounds or invalid cell size %.1f"), InCellSize);
+		return;
+	}
+
+	const FVector Size = WorldBounds.GetSize();
+	const FIntVector NewNumCells(
+		FMath::Max(FMath::CeilToInt(Size.X / InCellSize), 1),
+		FMath::Max(FMath::CeilToInt(Size.Y / InCellSize), 1),
+		FMath::Max(FMath::CeilToInt(Size.Z / InCellSize), 1));
+
+	const int64 TotalCells = (int64)NewNumCells.X * NewNumCells.Y * NewNumCells.Z;
+	if (TotalCells > MaxPVSCells)
+	{
+		UE_LOG(LogShooter, Error, TEXT("UShooterPVSData::Build - %lld cells (%dx%dx%d) is more than the %d supported, use a bigger cell size"), TotalCells, NewNumCells.X, NewNumCells.Y, NewNumCells.Z, MaxPVSCells);
+		return;
+	}
+
+	Origin = WorldBounds.Min;
+	CellSize = InCellSize;
+	NumCells = NewNumCells;
+
+	const int32 CellCount = GetNumCells();
+	VisibilityBits.SetNumZeroed(GetNumWords(CellCount));
+
+	// Sample points: the center of the cell plus a few random (but deterministic) points inside it, kept off the cell borders
+	SamplesPerCell = FMath::Max(SamplesPerCell, 1);
+	TArray<FVector> Samples;
+	Samples.SetNumUninitialized(CellCount * SamplesPerCell);
+
+	for (int32 CellIdx = 0; CellIdx < CellCount; ++CellIdx)
+	{
+		const FBox CellBounds = GetCellBounds(CellIdx).ExpandBy(-0.1f * CellSize);
+		FRandomStream RandomStream(CellIdx);
+
+		Samples[CellIdx * SamplesPerCell] = CellBounds.GetCenter();
+		for (int32 SampleIdx = 1; SampleIdx < SamplesPerCell; ++SampleIdx)
+		{
+			Samples[CellIdx * SamplesPerCell + SampleIdx] = FVector(
+				RandomStream.FRandRange(CellBounds.Min.X, CellBounds.Max.X),
+				RandomStream.FRandRange(CellBounds.Min.Y, CellBounds.Max.Y),
+				RandomStream.FRandRange(CellBounds.Min.Z, CellBounds.Max.Z));
+		}
+	}
+
+	const FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(ShooterPVSBake), true);
+	const FCollisionObjectQueryParams ObjectParams(ECC_WorldStatic);
+	const float MaxCenterDistSq = FMath::Square(MaxTraceDistance + CellSize * FMath::Sqrt(3.f));
+
+	int64 NumTraces = 0;
+	int32 NumVisiblePairs = 0;
+	int32 LastReportedPercent = 0;
+
+	for (int32 FromCell = 0; FromCell < CellCount; ++FromCell)
+	{
+		const FIntVector FromCoord(FromCell % NumCells.X, (FromCell / NumCells.X) % NumCells.Y, FromCell / (NumCells.X * NumCells.Y));
+
+		SetCellVisible(FromCell, FromCell);
+
+		for (int32 ToCell = FromCell + 1; ToCell < CellCount; ++ToCell)
+		{
+			const FIntVector ToCoord(ToCell % NumCells.X, (ToCell / NumCells.X) % NumCells.Y, ToCell / (NumCells.X * NumCells.Y));
+
+			// Neighbours are always visible: actors are bucketed by their origin but their bounds spill over into the next cell.
+			// Pairs beyond the trace distance are left to distance culling.
+			bool bVisible = FMath::Abs(FromCoord.X - ToCoord.X) <= 1 && FMath::Abs(FromCoord.Y - ToCoord.Y) <= 1 && FMath::Abs(FromCoord.Z - ToCoord.Z) <= 1;
+			bVisible = bVisible || FVector::DistSquared(Samples[FromCell * SamplesPerCell], Samples[ToCell * SamplesPerCell]) > MaxCenterDistSq;
+
+			for (int32 FromSample = 0; FromSample < SamplesPerCell && !bVisible; ++FromSample)
+			{
+				for (int32 ToSample = 0; ToSample < SamplesPerCell && !bVisible; ++ToSample)
+				{
+					++NumTraces;
+					bVisible = !World->LineTraceTestByObjectType(Samples[FromCell * SamplesPerCell + FromSample], Samples[ToCell * SamplesPerCell + ToSample], ObjectParams, TraceParams);
+				}
+			}
+
+			if (bVisible)
+			{
+				SetCellVisible(FromCell, ToCell);
+				SetCellVisible(ToCell, FromCell);
+				++NumVisiblePairs;
+			}
+		}
+
+		const int32 Percent = (FromCell + 1) * 100 / CellCount;
+		if (Percent >= LastReportedPercent + 10)
+		{
+			LastReportedPercent = Percent;
+			UE_LOG(LogShooter, Display, TEXT("UShooterPVSData::Build - %d%%"), Percent);
+		}
+	}
+
+	const int32 NumPairs = CellCount * (CellCount - 1) / 2;
+	UE_LOG(LogShooter, Display, TEXT("UShooterPVSData::Build - %dx%dx%d cells of %.0f, %d/%d pairs visible, %lld traces, %d KB, %.2fs"),
+		NumCells.X, NumCells.Y, NumCells.Z, CellSize, NumVisiblePairs, NumPairs, NumTraces, (int32)(VisibilityBits.Num() * sizeof(uint32) / 1024), FPlatformTime::Seconds() - StartTime);
+}
+
+FString UShooterPVSData::GetPackageNameForMap(const FString& MapPackageName)
+{
+	return FString::Printf(TEXT("/Game/Maps/PVS/%s_PVS"), *FPackageName::GetShortName(MapPackageName));
+}
+
+UShooterPVSData* UShooterPVSData::LoadForWorld(UWorld* World)
+{
+	if (World == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FString PackageName = GetPackageNameForMap(UWorld::RemovePIEPrefix(World->GetOutermost()->GetName()));
+	if (!FPackageName::DoesPackageExist(PackageName))
+	{
+		return nullptr;
+	}
+
+	const FString ObjectPath = PackageName + TEXT(".") + FPackageName::GetShortName(PackageName);
+	UShooterPVSData* Data = LoadObject<UShooterPVSData>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+
+	if (Data && !Data->IsValid())
+	{
+		UE_LOG(LogShooter, Warning, TEXT("UShooterPVSData::LoadForWorld - %s is empty, ignoring it"), *ObjectPath);
+		return nullptr;
+	}
+
+	return Data;
+}
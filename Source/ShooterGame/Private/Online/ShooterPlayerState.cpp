@@ -3,6 +3,7 @@
 #include "ShooterGame.h"
 #include "ShooterPlayerState.h"
 #include "Net/OnlineEngineInterface.h"
+#include "Online/ShooterPushModel.h"
 
 AShooterPlayerState::AShooterPlayerState(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -22,6 +23,8 @@ void AShooterPlayerState::Reset()
 	//SetTeamNum(0);
 	NumKills = 0;
 	NumDeaths = 0;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterPlayerState, NumKills, this);
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterPlayerState, NumDeaths, this);
 	NumBulletsFired = 0;
 	NumRocketsFired = 0;
 	bQuitter = false;
@@ -53,6 +56,7 @@ void AShooterPlayerState::ClientInitialize(AController* InController)
 void AShooterPlayerState::SetTeamNum(int32 NewTeamNumber)
 {
 	TeamNumber = NewTeamNumber;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterPlayerState, TeamNumber, this);
 
 	UpdateTeamColors();
 }
@@ -85,6 +89,7 @@ void AShooterPlayerState::CopyProperties(APlayerState* PlayerState)
 	if (ShooterPlayer)
 	{
 		ShooterPlayer->TeamNumber = TeamNumber;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterPlayerState, TeamNumber, ShooterPlayer);
 	}	
 }
 
@@ -134,12 +139,14 @@ bool AShooterPlayerState::IsQuitter() const
 void AShooterPlayerState::ScoreKill(AShooterPlayerState* Victim, int32 Points)
 {
 	NumKills++;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterPlayerState, NumKills, this);
 	ScorePoints(Points);
 }
 
 void AShooterPlayerState::ScoreDeath(AShooterPlayerState* KilledBy, int32 Points)
 {
 	NumDeaths++;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterPlayerState, NumDeaths, this);
 	ScorePoints(Points);
 }
 
@@ -159,49 +166,17 @@ void AShooterPlayerState::ScorePoints(int32 Points)
 	SetScore(GetScore() + Points);
 }
 
-void AShooterPlayerState::InformAboutKill_Implementation(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState)
-{
-	//id can be null for bots
-	if (KillerPlayerState->GetUniqueId().IsValid())
-	{	
-		//search for the actual killer before calling OnKill()	
-		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-		{		
-			AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
-			if (TestPC && TestPC->IsLocalController())
-			{
-				// a local player might not have an ID if it was created with CreateDebugPlayer.
-				ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(TestPC->Player);
-				FUniqueNetIdRepl LocalID = LocalPlayer->GetCachedUniqueNetId();
-				if (LocalID.IsValid() &&  *LocalPlayer->GetCachedUniqueNetId() == *KillerPlayerState->GetUniqueId())
-				{			
-					TestPC->OnKill();
-				}
-			}
-		}
-	}
-}
-
-void AShooterPlayerState::BroadcastDeath_Implementation(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState)
-{	
-	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-	{
-		// all local players get death messages so they can update their huds.
-		AShooterPlayerController* TestPC = Cast<AShooterPlayerController>(*It);
-		if (TestPC && TestPC->IsLocalController())
-		{
-			TestPC->OnDeathMessage(KillerPlayerState, this, KillerDamageType);				
-		}
-	}	
-}
-
 void AShooterPlayerState::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
-	DOREPLIFETIME( AShooterPlayerState, TeamNumber );
-	DOREPLIFETIME( AShooterPlayerState, NumKills );
-	DOREPLIFETIME( AShooterPlayerState, NumDeaths );
+	// push model: only compared when marked dirty (SHOOTER_MARK_PROPERTY_DIRTY)
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterPlayerState, TeamNumber, Params );
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterPlayerState, NumKills, Params );
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterPlayerState, NumDeaths, Params );
 }
 
 FString AShooterPlayerState::GetShortPlayerName() const
@@ -0,0 +1,35 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Online/ShooterPushModel.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+bool FShooterPushModelTracker::bRecording = false;
+TSet<TPair<FObjectKey, FName>> FShooterPushModelTracker::MarkedProperties;
+
+void FShooterPushModelTracker::StartRecording()
+{
+	MarkedProperties.Reset();
+	bRecording = true;
+}
+
+void FShooterPushModelTracker::StopRecording()
+{
+	bRecording = false;
+}
+
+void FShooterPushModelTracker::Record(const UObject* Object, FName PropertyName)
+{
+	if (bRecording)
+	{
+		MarkedProperties.Add(TPair<FObjectKey, FName>(Object, PropertyName));
+	}
+}
+
+bool FShooterPushModelTracker::WasMarked(const UObject* Object, FName PropertyName)
+{
+	return MarkedProperties.Contains(TPair<FObjectKey, FName>(Object, PropertyName));
+}
+
+#endif
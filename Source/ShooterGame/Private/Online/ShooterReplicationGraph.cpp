@@ -23,22 +23,41 @@
 *	
 *		These are the top level nodes currently used:
 *		
-*		UReplicationGraphNode_GridSpatialization2D: 
+*		UShooterReplicationGraphNode_GridSpatialization2D: 
 *		This is the spatialization node. All "distance based relevant" actors will be routed here. This node divides the map into a 2D grid. Each cell in the grid contains 
 *		children nodes that hold lists of actors based on how they update/go dormant. Actors are put in multiple cells. Connections pull from the single cell they are in.
+*		Unless ShooterRepGraph.AutoGrid is 0, the grid's bias and cell size are derived from the level bounds once the world is known (see ConfigureGridForWorld).
+*		The node periodically logs its gather/prepare timings (ShooterRepGraph.GridTimingLogInterval) so configurations can be compared.
+*		With ShooterRepGraph.CoarseGrid there are two of these: static and dormant actors go to a grid with ShooterRepGraph.CoarseGrid.CellSizeScale times
+*		bigger cells (CoarseGrid), so they are added to fewer cells, and only dynamic actors are in the fine one (Grid).
 *		
 *		UReplicationGraphNode_ActorList
 *		This is an actor list node that contains the always relevant actors. These actors are always relevant to every connection.
 *		
 *		UShooterReplicationGraphNode_AlwaysRelevant_ForConnection
-*		This is the node for connection specific always relevant actors. This node does not maintain a persistent list but builds it each frame. This is possible because (currently)
-*		these actors are all easily accessed from the PlayerController. A persistent list would require notifications to be broadcast when these actors change, which would be possible
-*		but currently not necessary.
+*		This is the node for connection specific always relevant actors. These actors are all easily accessed from the PlayerController, so each frame the node collects the handful
+*		of pointers and only rebuilds its persistent list when they differ from last frame (pawn/view target/PlayerState/inventory changed). Always relevant streaming level lists
+*		are only re-checked for dormancy every few frames (ShooterRepGraph.AlwaysRelevantLevelCheckPeriod), or when one of their actors is flushed or woken up.
 *		
 *		UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
 *		A custom node for handling player state replication. This replicates a small rolling set of player states (currently 2/frame). This is so player states replicate
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
-*		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection.
+*		owning connection only) via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection. Player states are routed to this node explicitly (they are NotRouted otherwise)
+*		and kept in persistent buckets, which are only compacted when a player state leaves.
+*		
+*		UShooterReplicationGraphNode_PVS
+*		Pawns (Spatialize_PVS) are not put in the grid but in this node. If the map has a baked potential visibility table (UShooterPVSData, see
+*		"ShooterRepGraph.PVS.Bake") pawns that cannot possibly be seen from the viewer's cell are culled with a bit lookup. Lists are shared between
+*		connections in the same cell. Without a table all pawns are returned and only distance culling applies.
+*		
+*		UShooterReplicationGraphNode_Projectiles
+*		Projectiles (Spatialize_Projectile) move too fast for the grid: by the time they get from one cell to the next they have been gathered for every
+*		connection in both. This node sweeps each projectile's predicted path by its cull distance once per frame and only returns it to connections
+*		whose viewer is inside that capsule. They also get their own (lower) replication frequency, see ShooterRepGraph.Projectile.ReplicationPeriodFrame.
+*		
+*		UShooterReplicationGraphNode_ViewPriority_ForConnection
+*		Connection specific node that gathers nothing. It scales the connection's replication period of each pawn by its angle to the viewer's view direction,
+*		so under a tight bandwidth budget pawns on screen (and whoever is shooting at the player) update more often than pawns behind the player.
 *		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
@@ -73,11 +92,21 @@
 *		Net.RepGraph.PrintAllActorInfo <ActorMatchString> - will print the class, global, and connection replication info associated with an actor/class. If MatchString is empty will print everything. Call directly from client.
 *		
 *		ShooterRepGraph.PrintRouting - will print the EClassRepNodeMapping for each class. That is, how a given actor class is routed (or not) in the Replication Graph.
+*		
+*		ShooterRepGraph.Telemetry 1 - collects gather time/actors per node, starvation/bandwidth per connection and bytes sent per actor class (on actor channels opened while it is set).
+*		Node values are also pushed to the CSV profiler (ShooterRepGraph category, bytes per class are in the engine's ReplicationGraph category).
+*		"ShooterRepGraph.Telemetry.Dump <File>" writes the totals to a CSV, "ShooterRepGraph.Telemetry.Reset" starts over.
+*		
+*		ShooterRepGraph.Governor 0 - stops the governor from lowering replication rates when the server is over its frame budget (back to the configured rates).
+*		Every adjustment it makes is logged ("Governor level") with the timings that caused it, the current level is the "Governor Level" stat.
+*		
+*		ShooterRepGraph.PVS.Draw <Radius> <Duration> - will draw the PVS cells around the local view: green cells are visible from the viewer's (yellow) cell, red ones are culled.
 *	
 */
 
 #include "ShooterGame.h"
 #include "ShooterReplicationGraph.h"
+#include "ShooterActorChannel.h"
 
 #include "Net/UnrealNetwork.h"
 #include "Engine/LevelStreaming.h"
@@ -97,6 +126,15 @@
 #include "Online/ShooterPlayerState.h"
 #include "Weapons/ShooterWeapon.h"
 #include "Pickups/ShooterPickup.h"
+#include "Weapons/ShooterProjectile.h"
+#include "Online/ShooterPVSData.h"
+#include "Bots/ShooterAIController.h"
+#include "Misc/PackageName.h"
+#include "Engine/LevelBounds.h"
+
+#if WITH_EDITOR
+#include "AssetRegistryModule.h"
+#endif
 
 DEFINE_LOG_CATEGORY( LogShooterReplicationGraph );
 
@@ -117,13 +155,88 @@ static FAutoConsoleVariableRef CVarShooterRepGraphSpatialBiasX(TEXT("ShooterRepG
 float CVar_ShooterRepGraph_SpatialBiasY = -200000.f;
 static FAutoConsoleVariableRef CVarShooterRepSpatialBiasY(TEXT("ShooterRepGraph.SpatialBiasY"), CVar_ShooterRepGraph_SpatialBiasY, TEXT(""), ECVF_Default );
 
+// Derive the grid bias and cell size from the level bounds instead of SpatialBiasX/Y and CellSize
+int32 CVar_ShooterRepGraph_AutoGrid = 1;
+static FAutoConsoleVariableRef CVarShooterRepGraphAutoGrid(TEXT("ShooterRepGraph.AutoGrid"), CVar_ShooterRepGraph_AutoGrid, TEXT("Size the spatialization grid from the level bounds (0 = use ShooterRepGraph.CellSize/SpatialBiasX/SpatialBiasY)"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_AutoGridCellsPerAxis = 8;
+static FAutoConsoleVariableRef CVarShooterRepGraphAutoGridCellsPerAxis(TEXT("ShooterRepGraph.AutoGrid.CellsPerAxis"), CVar_ShooterRepGraph_AutoGridCellsPerAxis, TEXT("Number of cells the longest side of the level is divided into"), ECVF_Default );
+
+// Cells much smaller than the cull distance put every dynamic actor in a lot of cells, cells much bigger gather far away actors. Clamp to a sensible range around the cull distances.
+float CVar_ShooterRepGraph_AutoGridMinCellSize = 2500.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphAutoGridMinCellSize(TEXT("ShooterRepGraph.AutoGrid.MinCellSize"), CVar_ShooterRepGraph_AutoGridMinCellSize, TEXT(""), ECVF_Default );
+
+float CVar_ShooterRepGraph_AutoGridMaxCellSize = 20000.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphAutoGridMaxCellSize(TEXT("ShooterRepGraph.AutoGrid.MaxCellSize"), CVar_ShooterRepGraph_AutoGridMaxCellSize, TEXT(""), ECVF_Default );
+
+// Static and dormant actors go to a second grid with bigger cells. Read when the graph is created.
+int32 CVar_ShooterRepGraph_CoarseGrid = 1;
+static FAutoConsoleVariableRef CVarShooterRepGraphCoarseGrid(TEXT("ShooterRepGraph.CoarseGrid"), CVar_ShooterRepGraph_CoarseGrid, TEXT("Route static and dormant actors to a grid with bigger cells than the dynamic ones (takes effect for new replication graphs)"), ECVF_Default );
+
+float CVar_ShooterRepGraph_CoarseGridCellSizeScale = 4.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphCoarseGridCellSizeScale(TEXT("ShooterRepGraph.CoarseGrid.CellSizeScale"), CVar_ShooterRepGraph_CoarseGridCellSizeScale, TEXT("Cell size of the coarse grid relative to the fine one"), ECVF_Default );
+
+float CVar_ShooterRepGraph_GridTimingLogInterval = 30.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphGridTimingLogInterval(TEXT("ShooterRepGraph.GridTimingLogInterval"), CVar_ShooterRepGraph_GridTimingLogInterval, TEXT("Seconds between logging grid gather timings, 0 to disable"), ECVF_Default );
+
+// Levels whose always relevant actors are all dormant on a connection stop being gathered. This is how often (frames) the levels still gathered are checked for that.
+int32 CVar_ShooterRepGraph_AlwaysRelevantLevelCheckPeriod = 10;
+static FAutoConsoleVariableRef CVarShooterRepGraphAlwaysRelevantLevelCheckPeriod(TEXT("ShooterRepGraph.AlwaysRelevantLevelCheckPeriod"), CVar_ShooterRepGraph_AlwaysRelevantLevelCheckPeriod, TEXT(""), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_ViewPriority = 1;
+static FAutoConsoleVariableRef CVarShooterRepGraphViewPriority(TEXT("ShooterRepGraph.ViewPriority"), CVar_ShooterRepGraph_ViewPriority, TEXT("Replicate pawns outside of the viewer's view cone less often"), ECVF_Default );
+
+// Full horizontal FOV in degrees, a bit wider than the camera so pawns about to come on screen are already up to date
+float CVar_ShooterRepGraph_ViewPriorityFOV = 110.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphViewPriorityFOV(TEXT("ShooterRepGraph.ViewPriority.FOV"), CVar_ShooterRepGraph_ViewPriorityFOV, TEXT("View cone (degrees) pawns replicate at their full rate in"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_ViewPriorityOffScreenScale = 2;
+static FAutoConsoleVariableRef CVarShooterRepGraphViewPriorityOffScreenScale(TEXT("ShooterRepGraph.ViewPriority.OffScreenScale"), CVar_ShooterRepGraph_ViewPriorityOffScreenScale, TEXT("Replication period multiplier for pawns outside the view cone but in front of the viewer"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_ViewPriorityBehindScale = 4;
+static FAutoConsoleVariableRef CVarShooterRepGraphViewPriorityBehindScale(TEXT("ShooterRepGraph.ViewPriority.BehindScale"), CVar_ShooterRepGraph_ViewPriorityBehindScale, TEXT("Replication period multiplier for pawns behind the viewer"), ECVF_Default );
+
+float CVar_ShooterRepGraph_ViewPriorityAttackerTime = 3.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphViewPriorityAttackerTime(TEXT("ShooterRepGraph.ViewPriority.AttackerTime"), CVar_ShooterRepGraph_ViewPriorityAttackerTime, TEXT("Seconds a pawn that damaged the viewer keeps replicating at full rate"), ECVF_Default );
+
 // How many buckets to spread dynamic, spatialized actors across. High number = more buckets = smaller effective replication frequency. This happens before individual actors do their own NetUpdateFrequency check.
 int32 CVar_ShooterRepGraph_DynamicActorFrequencyBuckets = 3;
-static FAutoConsoleVariableRef CVarShooterRepDynamicActorFrequencyBuckets(TEXT("ShooterRepGraph.DynamicActorFrequencyBuckets"), CVar_ShooterRepGraph_DynamicActorFrequencyBuckets, TEXT(""), ECVF_Default );
+static FAutoConsoleVariableRef CVarShooterRepDynamicActorFrequencyBuckets(TEXT("ShooterRepGraph.DynamicActorFrequencyBuckets"), CVar_ShooterRepGraph_DynamicActorFrequencyBuckets, TEXT("Frequency buckets of dynamic actors in the grid cells, the governor's lower bound"), ECVF_Default );
 
 int32 CVar_ShooterRepGraph_DisableSpatialRebuilds = 1;
 static FAutoConsoleVariableRef CVarShooterRepDisableSpatialRebuilds(TEXT("ShooterRepGraph.DisableSpatialRebuilds"), CVar_ShooterRepGraph_DisableSpatialRebuilds, TEXT(""), ECVF_Default );
 
+// How far ahead (seconds) a projectile's path is swept when deciding which connections it is relevant to. Capped by the projectile's remaining life span.
+float CVar_ShooterRepGraph_ProjectileMaxLookahead = 2.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphProjectileMaxLookahead(TEXT("ShooterRepGraph.Projectile.MaxLookahead"), CVar_ShooterRepGraph_ProjectileMaxLookahead, TEXT("Seconds of projectile flight considered when gathering projectiles for a connection"), ECVF_Default );
+
+// Projectile movement is simulated on clients, after the initial bunch they only need the occasional correction. Read in InitGlobalActorClassSettings.
+int32 CVar_ShooterRepGraph_ProjectileReplicationPeriodFrame = 3;
+static FAutoConsoleVariableRef CVarShooterRepGraphProjectileReplicationPeriodFrame(TEXT("ShooterRepGraph.Projectile.ReplicationPeriodFrame"), CVar_ShooterRepGraph_ProjectileReplicationPeriodFrame, TEXT("Replicate projectiles every N frames (ForceNetUpdate still replicates immediately)"), ECVF_Default );
+
+DECLARE_STATS_GROUP(TEXT("ShooterRepGraph"), STATGROUP_ShooterRepGraph, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("PlayerState Limiter Tracked"), STAT_ShooterRepGraph_PlayerStatesTracked, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("PlayerState Limiter Buckets"), STAT_ShooterRepGraph_PlayerStateBuckets, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PlayerState Limiter Actors Visited"), STAT_ShooterRepGraph_PlayerStatesVisited, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PlayerState Limiter Rebuilds"), STAT_ShooterRepGraph_PlayerStateRebuilds, STATGROUP_ShooterRepGraph);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Tracked"), STAT_ShooterRepGraph_ProjectilesTracked, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Gathered"), STAT_ShooterRepGraph_ProjectilesGathered, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Culled"), STAT_ShooterRepGraph_ProjectilesCulled, STATGROUP_ShooterRepGraph);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("AlwaysRelevant List Rebuilds"), STAT_ShooterRepGraph_AlwaysRelevantRebuilds, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AlwaysRelevant Level Dormancy Checks"), STAT_ShooterRepGraph_AlwaysRelevantLevelChecks, STATGROUP_ShooterRepGraph);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("ViewPriority Full Rate"), STAT_ShooterRepGraph_ViewPriorityFull, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("ViewPriority Off Screen"), STAT_ShooterRepGraph_ViewPriorityOffScreen, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("ViewPriority Behind"), STAT_ShooterRepGraph_ViewPriorityBehind, STATGROUP_ShooterRepGraph);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Governor Level"), STAT_ShooterRepGraph_GovernorLevel, STATGROUP_ShooterRepGraph);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("PVS Cell Lists Built"), STAT_ShooterRepGraph_PVSCellListsBuilt, STATGROUP_ShooterRepGraph);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PVS Actors Culled"), STAT_ShooterRepGraph_PVSActorsCulled, STATGROUP_ShooterRepGraph);
+
 // ----------------------------------------------------------------------------------------------------------
 
 
@@ -180,6 +293,218 @@ void UShooterReplicationGraph::ResetGameWorldState()
 	}
 }
 
+void UShooterReplicationGraph::SetRepDriverWorld(UWorld* InWorld)
+{
+	Super::SetRepDriverWorld(InWorld);
+
+	ConfigureGridForWorld(InWorld);
+
+	if (PVSNode)
+	{
+		UShooterPVSData* PVSData = UShooterPVSData::LoadForWorld(InWorld);
+		UE_CLOG(InWorld && PVSData == nullptr, LogShooterReplicationGraph, Log, TEXT("No PVS table for %s, pawns will only be distance culled"), *InWorld->GetOutermost()->GetName());
+
+		PVSNode->SetPVSData(PVSData);
+	}
+}
+
+void UShooterReplicationGraph::UpdateActorChannelClass()
+{
+	FChannelDefinition* ActorChannelDefinition = NetDriver ? NetDriver->ChannelDefinitionMap.Find(NAME_Actor) : nullptr;
+	if (ActorChannelDefinition == nullptr)
+	{
+		return;
+	}
+
+	// only ever swapped with the engine's own, a project wide actor channel class is left alone
+	if (FShooterRepGraphTelemetry::IsEnabled())
+	{
+		if (ActorChannelDefinition->ChannelClass == UActorChannel::StaticClass())
+		{
+			ActorChannelDefinition->ChannelClass = UShooterActorChannel::StaticClass();
+		}
+	}
+	else if (ActorChannelDefinition->ChannelClass == UShooterActorChannel::StaticClass())
+	{
+		ActorChannelDefinition->ChannelClass = UActorChannel::StaticClass();
+	}
+}
+
+int32 UShooterReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	UpdateActorChannelClass();
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const int32 Result = Super::ServerReplicateActors(DeltaSeconds);
+
+	const float ReplicationSeconds = (float)(FPlatformTime::Seconds() - StartTime);
+
+	if (FShooterRepGraphTelemetry::IsEnabled())
+	{
+		Telemetry.EndFrame(Connections);
+	}
+
+	if (NetDriver && NetDriver->NetServerMaxTickRate > 0)
+	{
+		// DeltaSeconds includes the sleep that holds the server at its tick rate, only the busy part counts against the budget
+		const float FrameSeconds = FMath::Max(DeltaSeconds - (float)FApp::GetIdleTime(), 0.f);
+		if (Governor.Update(FrameSeconds, ReplicationSeconds, 1.f / NetDriver->NetServerMaxTickRate))
+		{
+			ApplyGovernorLevel();
+		}
+	}
+
+	return Result;
+}
+
+void UShooterReplicationGraph::ApplyGovernorLevel()
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	const int32 NumBuckets = Governor.GetFrequencyBuckets(CVar_ShooterRepGraph_DynamicActorFrequencyBuckets);
+	const int32 PlayerStatesPerFrame = Governor.GetPlayerStatesPerFrame(BasePlayerStatesPerFrame);
+	const uint32 PeriodScale = Governor.GetPeriodScale();
+
+	// Dynamic actors in the grid cells. Cells created later pick up the default.
+	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.NumBuckets = NumBuckets;
+	for (TObjectIterator<UReplicationGraphNode_ActorListFrequencyBuckets> It; It; ++It)
+	{
+		if (It->IsIn(this))
+		{
+			It->SetNonStreamingCollectionSize(NumBuckets);
+		}
+	}
+
+	if (PlayerStateNode)
+	{
+		// The node rebuilds its buckets when this changes
+		PlayerStateNode->TargetActorsPerFrame = PlayerStatesPerFrame;
+	}
+
+	int32 NumClassesChanged = 0;
+	int32 NumActorsChanged = 0;
+	int32 NumConnectionActorsChanged = 0;
+
+	if (PeriodScale != AppliedPeriodScale)
+	{
+		// Old and new period per spatialized class. Only things that are still at the old period are changed, so per actor/connection overrides (own PlayerState, view priority) are left alone.
+		TMap<UClass*, TPair<uint32, uint32>> ChangedPeriods;
+
+		for (auto ClassRepInfoIt = GlobalActorReplicationInfoMap.CreateClassMapIterator(); ClassRepInfoIt; ++ClassRepInfoIt)
+		{
+			UClass* Class = Cast<UClass>(ClassRepInfoIt.Key().ResolveObjectPtr());
+			const EClassRepNodeMapping* Mapping = Class ? ClassRepNodePolicies.Get(Class) : nullptr;
+			if (Mapping == nullptr || !IsSpatialized(*Mapping))
+			{
+				continue;
+			}
+
+			// Classes looked up after init were copied from their parent
+			const uint32* BasePeriod = nullptr;
+			for (UClass* BaseClass = Class; BaseClass && BasePeriod == nullptr; BaseClass = BaseClass->GetSuperClass())
+			{
+				BasePeriod = BaseClassReplicationPeriods.Find(BaseClass);
+			}
+
+			if (BasePeriod)
+			{
+				FClassReplicationInfo& ClassInfo = ClassRepInfoIt.Value();
+				ChangedPeriods.Add(Class, TPair<uint32, uint32>(ClassInfo.ReplicationPeriodFrame, *BasePeriod * PeriodScale));
+				ClassInfo.ReplicationPeriodFrame = *BasePeriod * PeriodScale;
+				++NumClassesChanged;
+			}
+		}
+
+		for (auto ActorIt = GlobalActorReplicationInfoMap.CreateActorMapIterator(); ActorIt; ++ActorIt)
+		{
+			const TPair<uint32, uint32>* Periods = ChangedPeriods.Find(ActorIt.Key()->GetClass());
+			if (Periods && ActorIt.Value()->Settings.ReplicationPeriodFrame == Periods->Key)
+			{
+				ActorIt.Value()->Settings.ReplicationPeriodFrame = Periods->Value;
+				++NumActorsChanged;
+			}
+		}
+
+		for (UNetReplicationGraphConnection* ConnManager : Connections)
+		{
+			for (auto ConnectionActorIt = ConnManager->ActorInfoMap.CreateIterator(); ConnectionActorIt; ++ConnectionActorIt)
+			{
+				const TPair<uint32, uint32>* Periods = ChangedPeriods.Find(ConnectionActorIt.Key()->GetClass());
+				FConnectionReplicationActorInfo& ConnectionActorInfo = *ConnectionActorIt.Value();
+				if (Periods && ConnectionActorInfo.ReplicationPeriodFrame == Periods->Key)
+				{
+					ConnectionActorInfo.ReplicationPeriodFrame = Periods->Value;
+					ConnectionActorInfo.NextReplicationFrameNum = FMath::Min(ConnectionActorInfo.NextReplicationFrameNum, ConnectionActorInfo.LastRepFrameNum + ConnectionActorInfo.ReplicationPeriodFrame);
+					++NumConnectionActorsChanged;
+				}
+			}
+		}
+
+		AppliedPeriodScale = PeriodScale;
+	}
+
+	SET_DWORD_STAT(STAT_ShooterRepGraph_GovernorLevel, Governor.GetLevel());
+
+	UE_LOG(LogShooterReplicationGraph, Display, TEXT("Governor level %d (%s): %d dynamic frequency buckets, %d player states per frame, replication period x%u (%d classes, %d actors, %d connection actors updated in %.2fms)"),
+		Governor.GetLevel(), *Governor.GetLastReason(), NumBuckets, PlayerStatesPerFrame, PeriodScale,
+		NumClassesChanged, NumActorsChanged, NumConnectionActorsChanged, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UShooterReplicationGraph::ConfigureGridForWorld(UWorld* InWorld)
+{
+	if (GridNode == nullptr || InWorld == nullptr || !CVar_ShooterRepGraph_AutoGrid)
+	{
+		return;
+	}
+
+	FBox LevelBounds(ForceInit);
+	for (ULevel* Level : InWorld->GetLevels())
+	{
+		if (Level)
+		{
+			LevelBounds += ALevelBounds::CalculateLevelBounds(Level);
+		}
+	}
+
+	if (!LevelBounds.IsValid)
+	{
+		UE_LOG(LogShooterReplicationGraph, Log, TEXT("No level bounds for %s, keeping grid CellSize %.0f Bias %s"), *InWorld->GetOutermost()->GetName(), GridNode->CellSize, *GridNode->SpatialBias.ToString());
+		return;
+	}
+
+	const FVector Size = LevelBounds.GetSize();
+	const float LongestSide = FMath::Max(Size.X, Size.Y);
+	const float FineCellSize = FMath::Clamp(LongestSide / FMath::Max(CVar_ShooterRepGraph_AutoGridCellsPerAxis, 1), CVar_ShooterRepGraph_AutoGridMinCellSize, CVar_ShooterRepGraph_AutoGridMaxCellSize);
+
+	for (UReplicationGraphNode_GridSpatialization2D* Node : { GridNode, CoarseGridNode })
+	{
+		if (Node == nullptr)
+		{
+			continue;
+		}
+
+		const float CellSize = Node == CoarseGridNode ? FineCellSize * FMath::Max(CVar_ShooterRepGraph_CoarseGridCellSizeScale, 1.f) : FineCellSize;
+
+		// One cell of slack so actors on the edge of the level (or falling off it) don't immediately trigger a grid rebuild
+		const FVector2D SpatialBias = FVector2D(LevelBounds.Min.X, LevelBounds.Min.Y) - FVector2D(CellSize, CellSize);
+
+		UE_LOG(LogShooterReplicationGraph, Display, TEXT("%s for %s: level bounds %s, CellSize %.0f -> %.0f, Bias %s -> %s, %dx%d cells"),
+			Node == CoarseGridNode ? TEXT("CoarseGrid") : TEXT("Grid"), *InWorld->GetOutermost()->GetName(), *LevelBounds.ToString(), Node->CellSize, CellSize, *Node->SpatialBias.ToString(), *SpatialBias.ToString(),
+			FMath::CeilToInt(Size.X / CellSize) + 1, FMath::CeilToInt(Size.Y / CellSize) + 1);
+
+		if (UShooterReplicationGraphNode_GridSpatialization2D* ShooterGridNode = Cast<UShooterReplicationGraphNode_GridSpatialization2D>(Node))
+		{
+			ShooterGridNode->SetGrid(CellSize, SpatialBias);
+		}
+		else
+		{
+			Node->CellSize = CellSize;
+			Node->SpatialBias = SpatialBias;
+		}
+	}
+}
+
 void UShooterReplicationGraph::InitGlobalActorClassSettings()
 {
 	Super::InitGlobalActorClassSettings();
@@ -195,7 +520,9 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	AddInfo( APlayerState::StaticClass(),							EClassRepNodeMapping::NotRouted);				// Special cased via UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
 	AddInfo( AReplicationGraphDebugActor::StaticClass(),			EClassRepNodeMapping::NotRouted);				// Not needed. Replicated special case inside RepGraph
 	AddInfo( AInfo::StaticClass(),									EClassRepNodeMapping::RelevantAllConnections);	// Non spatialized, relevant to all
-	AddInfo( AShooterPickup::StaticClass(),							EClassRepNodeMapping::Spatialize_Static);		// Spatialized and never moves. Routes to GridNode.
+	AddInfo( AShooterPickup::StaticClass(),							EClassRepNodeMapping::Spatialize_Dormancy);		// Spatialized, never moves and dormant unless picked up/respawned. Routes to CoarseGridNode.
+	AddInfo( AShooterCharacter::StaticClass(),						EClassRepNodeMapping::Spatialize_PVS);			// Culled against the baked PVS table. Routes to PVSNode.
+	AddInfo( AShooterProjectile::StaticClass(),						EClassRepNodeMapping::Spatialize_Projectile);	// Fast movers, culled along their path. Routes to ProjectileNode.
 
 #if WITH_GAMEPLAY_DEBUGGER
 	AddInfo( AGameplayDebuggerCategoryReplicator::StaticClass(),	EClassRepNodeMapping::NotRouted);				// Replicated via UShooterReplicationGraphNode_AlwaysRelevant_ForConnection
@@ -284,12 +611,20 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	PawnClassRepInfo.SetCullDistanceSquared(15000.f * 15000.f); // Yuck
 	SetClassInfo( APawn::StaticClass(), PawnClassRepInfo );
 
+	FClassReplicationInfo ProjectileRepInfo;
+	ProjectileRepInfo.DistancePriorityScale = 1.f;
+	ProjectileRepInfo.StarvationPriorityScale = 1.f;
+	ProjectileRepInfo.ReplicationPeriodFrame = FMath::Max(CVar_ShooterRepGraph_ProjectileReplicationPeriodFrame, 1);
+	ProjectileRepInfo.SetCullDistanceSquared(0.f); // Culled by UShooterReplicationGraphNode_Projectiles along the projectile's path, not at its current location
+	SetClassInfo( AShooterProjectile::StaticClass(), ProjectileRepInfo );
+
 	FClassReplicationInfo PlayerStateRepInfo;
 	PlayerStateRepInfo.DistancePriorityScale = 0.f;
 	PlayerStateRepInfo.ActorChannelFrameTimeout = 0;
 	SetClassInfo( APlayerState::StaticClass(), PlayerStateRepInfo );
 	
 	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.ListSize = 12;
+	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.NumBuckets = FMath::Max(CVar_ShooterRepGraph_DynamicActorFrequencyBuckets, 1);
 
 	// Set FClassReplicationInfo based on legacy settings from all replicated classes
 	for (UClass* ReplicatedClass : AllReplicatedClasses)
@@ -306,6 +641,14 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 		GlobalActorReplicationInfoMap.SetClassInfo( ReplicatedClass, ClassInfo );
 	}
 
+	// What the governor scales under load
+	BaseClassReplicationPeriods.Reset();
+	AppliedPeriodScale = 1;
+	for (auto ClassRepInfoIt = GlobalActorReplicationInfoMap.CreateClassMapIterator(); ClassRepInfoIt; ++ClassRepInfoIt)
+	{
+		BaseClassReplicationPeriods.Add(ClassRepInfoIt.Key(), ClassRepInfoIt.Value().ReplicationPeriodFrame);
+	}
+
 
 	// Print out what we came up with
 	UE_LOG(LogShooterReplicationGraph, Log, TEXT(""));
@@ -338,6 +681,24 @@ void UShooterReplicationGraph::InitGlobalActorClassSettings()
 	}
 
 
+	// Bytes/time spent per class in the CSV profiler (ReplicationGraph category), and bytes per class in the telemetry CSV. Everything else is lumped into "Other".
+	const TPair<UClass*, FName> TrackedClasses[] =
+	{
+		{ AShooterCharacter::StaticClass(), TEXT("Pawn") },
+		{ AShooterWeapon::StaticClass(), TEXT("Weapon") },
+		{ AShooterProjectile::StaticClass(), TEXT("Projectile") },
+		{ AShooterPickup::StaticClass(), TEXT("Pickup") },
+		{ APlayerState::StaticClass(), TEXT("PlayerState") },
+		{ APlayerController::StaticClass(), TEXT("PlayerController") },
+		{ AGameStateBase::StaticClass(), TEXT("GameState") },
+	};
+
+	for (const TPair<UClass*, FName>& TrackedClass : TrackedClasses)
+	{
+		CSVTracker.SetExplicitClassTracking(TrackedClass.Key, TrackedClass.Value);
+		Telemetry.SetClassTracking(TrackedClass.Key, TrackedClass.Value);
+	}
+
 	// Rep destruct infos based on CVar value
 	DestructInfoMaxDistanceSquared = CVar_ShooterRepGraph_DestructionInfoMaxDist * CVar_ShooterRepGraph_DestructionInfoMaxDist;
 
@@ -368,16 +729,35 @@ void UShooterReplicationGraph::InitGlobalGraphNodes()
 	//	Spatial Actors
 	// -----------------------------------------------
 
-	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
-	GridNode->CellSize = CVar_ShooterRepGraph_CellSize;
-	GridNode->SpatialBias = FVector2D(CVar_ShooterRepGraph_SpatialBiasX, CVar_ShooterRepGraph_SpatialBiasY);
+	// Initial values, replaced by ConfigureGridForWorld once the world is known (unless ShooterRepGraph.AutoGrid is 0)
+	UShooterReplicationGraphNode_GridSpatialization2D* FineGridNode = CreateNewNode<UShooterReplicationGraphNode_GridSpatialization2D>();
+	FineGridNode->CellSize = CVar_ShooterRepGraph_CellSize;
+	FineGridNode->SpatialBias = FVector2D(CVar_ShooterRepGraph_SpatialBiasX, CVar_ShooterRepGraph_SpatialBiasY);
+	GridNode = FineGridNode;
 
-	if (CVar_ShooterRepGraph_DisableSpatialRebuilds)
+	if (CVar_ShooterRepGraph_CoarseGrid)
 	{
-		GridNode->AddSpatialRebuildBlacklistClass(AActor::StaticClass()); // Disable All spatial rebuilding
+		UShooterReplicationGraphNode_GridSpatialization2D* ShooterCoarseGridNode = CreateNewNode<UShooterReplicationGraphNode_GridSpatialization2D>();
+		ShooterCoarseGridNode->GridName = TEXT("CoarseGrid");
+		ShooterCoarseGridNode->CellSize = CVar_ShooterRepGraph_CellSize * FMath::Max(CVar_ShooterRepGraph_CoarseGridCellSizeScale, 1.f);
+		ShooterCoarseGridNode->SpatialBias = GridNode->SpatialBias;
+		CoarseGridNode = ShooterCoarseGridNode;
+	}
+
+	for (UReplicationGraphNode_GridSpatialization2D* Node : { GridNode, CoarseGridNode })
+	{
+		if (Node == nullptr)
+		{
+			continue;
+		}
+
+		if (CVar_ShooterRepGraph_DisableSpatialRebuilds)
+		{
+			Node->AddSpatialRebuildBlacklistClass(AActor::StaticClass()); // Disable All spatial rebuilding
+		}
+
+		AddGlobalGraphNode(Node);
 	}
-	
-	AddGlobalGraphNode(GridNode);
 
 	// -----------------------------------------------
 	//	Always Relevant (to everyone) Actors
@@ -388,8 +768,21 @@ void UShooterReplicationGraph::InitGlobalGraphNodes()
 	// -----------------------------------------------
 	//	Player State specialization. This will return a rolling subset of the player states to replicate
 	// -----------------------------------------------
-	UShooterReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<UShooterReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	PlayerStateNode = CreateNewNode<UShooterReplicationGraphNode_PlayerStateFrequencyLimiter>();
 	AddGlobalGraphNode(PlayerStateNode);
+	BasePlayerStatesPerFrame = PlayerStateNode->TargetActorsPerFrame;
+
+	// -----------------------------------------------
+	//	Pawns, culled by the baked potential visibility table of the map (loaded in SetRepDriverWorld)
+	// -----------------------------------------------
+	PVSNode = CreateNewNode<UShooterReplicationGraphNode_PVS>();
+	AddGlobalGraphNode(PVSNode);
+
+	// -----------------------------------------------
+	//	Projectiles, gathered along their predicted path
+	// -----------------------------------------------
+	ProjectileNode = CreateNewNode<UShooterReplicationGraphNode_Projectiles>();
+	AddGlobalGraphNode(ProjectileNode);
 }
 
 void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
@@ -403,6 +796,8 @@ void UShooterReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConn
 	RepGraphConnection->OnClientVisibleLevelNameRemove.AddUObject(AlwaysRelevantConnectionNode, &UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
 
 	AddConnectionGraphNode(AlwaysRelevantConnectionNode, RepGraphConnection);
+
+	AddConnectionGraphNode(CreateNewNode<UShooterReplicationGraphNode_ViewPriority_ForConnection>(), RepGraphConnection);
 }
 
 EClassRepNodeMapping UShooterReplicationGraph::GetMappingPolicy(UClass* Class)
@@ -419,6 +814,11 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 	{
 		case EClassRepNodeMapping::NotRouted:
 		{
+			// Player states are special cased: they only go to the frequency limiter node
+			if (ActorInfo.Class->IsChildOf(APlayerState::StaticClass()))
+			{
+				PlayerStateNode->NotifyAddNetworkActor(ActorInfo);
+			}
 			break;
 		}
 		
@@ -433,13 +833,18 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 				FActorRepListRefView& RepList = AlwaysRelevantStreamingLevelActors.FindOrAdd(ActorInfo.StreamingLevelName);
 				RepList.PrepareForWrite();
 				RepList.ConditionalAdd(ActorInfo.Actor);
+
+				// Connections stop gathering a level once everything in it is dormant for them, these bring it back
+				GlobalInfo.Events.DormancyFlush.AddUObject(this, &UShooterReplicationGraph::OnAlwaysRelevantStreamingActorDormancyFlush);
+				GlobalInfo.Events.DormancyChange.AddUObject(this, &UShooterReplicationGraph::OnAlwaysRelevantStreamingActorDormancyChange);
+				NotifyAlwaysRelevantStreamingLevelChanged(ActorInfo.StreamingLevelName);
 			}
 			break;
 		}
 
 		case EClassRepNodeMapping::Spatialize_Static:
 		{
-			GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+			GetStaticGridNode()->AddActor_Static(ActorInfo, GlobalInfo);
 			break;
 		}
 		
@@ -451,7 +856,19 @@ void UShooterReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedA
 		
 		case EClassRepNodeMapping::Spatialize_Dormancy:
 		{
-			GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+			GetStaticGridNode()->AddActor_Dormancy(ActorInfo, GlobalInfo);
+			break;
+		}
+
+		case EClassRepNodeMapping::Spatialize_PVS:
+		{
+			PVSNode->NotifyAddNetworkActor(ActorInfo);
+			break;
+		}
+
+		case EClassRepNodeMapping::Spatialize_Projectile:
+		{
+			ProjectileNode->NotifyAddNetworkActor(ActorInfo);
 			break;
 		}
 	};
@@ -464,6 +881,10 @@ void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicat
 	{
 		case EClassRepNodeMapping::NotRouted:
 		{
+			if (ActorInfo.Class->IsChildOf(APlayerState::StaticClass()))
+			{
+				PlayerStateNode->NotifyRemoveNetworkActor(ActorInfo);
+			}
 			break;
 		}
 		
@@ -479,14 +900,20 @@ void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicat
 				if (RepList.Remove(ActorInfo.Actor) == false)
 				{
 					UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Actor %s was not found in AlwaysRelevantStreamingLevelActors list. LevelName: %s"), *GetActorRepListTypeDebugString(ActorInfo.Actor), *ActorInfo.StreamingLevelName.ToString());
-				}				
+				}
+
+				if (FGlobalActorReplicationInfo* GlobalInfo = GlobalActorReplicationInfoMap.Find(ActorInfo.Actor))
+				{
+					GlobalInfo->Events.DormancyFlush.RemoveAll(this);
+					GlobalInfo->Events.DormancyChange.RemoveAll(this);
+				}
 			}
 			break;
 		}
 
 		case EClassRepNodeMapping::Spatialize_Static:
 		{
-			GridNode->RemoveActor_Static(ActorInfo);
+			GetStaticGridNode()->RemoveActor_Static(ActorInfo);
 			break;
 		}
 		
@@ -498,10 +925,55 @@ void UShooterReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicat
 		
 		case EClassRepNodeMapping::Spatialize_Dormancy:
 		{
-			GridNode->RemoveActor_Dormancy(ActorInfo);
+			GetStaticGridNode()->RemoveActor_Dormancy(ActorInfo);
+			break;
+		}
+
+		case EClassRepNodeMapping::Spatialize_PVS:
+		{
+			PVSNode->NotifyRemoveNetworkActor(ActorInfo);
 			break;
 		}
+
+		case EClassRepNodeMapping::Spatialize_Projectile:
+		{
+			ProjectileNode->NotifyRemoveNetworkActor(ActorInfo);
+			break;
+		}
+	};
+}
+
+void UShooterReplicationGraph::OnAlwaysRelevantStreamingActorDormancyFlush(FActorRepListType Actor, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	NotifyAlwaysRelevantStreamingLevelChanged(FNewReplicatedActorInfo(Actor).StreamingLevelName);
+}
+
+void UShooterReplicationGraph::OnAlwaysRelevantStreamingActorDormancyChange(FActorRepListType Actor, FGlobalActorReplicationInfo& GlobalInfo, ENetDormancy NewValue, ENetDormancy OldValue)
+{
+	if (NewValue <= DORM_Awake)
+	{
+		NotifyAlwaysRelevantStreamingLevelChanged(FNewReplicatedActorInfo(Actor).StreamingLevelName);
+	}
+}
+
+void UShooterReplicationGraph::NotifyAlwaysRelevantStreamingLevelChanged(FName LevelName)
+{
+	auto NotifyConnections = [LevelName](const TArray<UNetReplicationGraphConnection*>& GraphConnections)
+	{
+		for (UNetReplicationGraphConnection* ConnManager : GraphConnections)
+		{
+			for (UReplicationGraphNode* ConnectionNode : ConnManager->GetConnectionGraphNodes())
+			{
+				if (UShooterReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = Cast<UShooterReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode))
+				{
+					AlwaysRelevantConnectionNode->OnStreamingLevelActorsChanged(LevelName);
+				}
+			}
+		}
 	};
+
+	NotifyConnections(Connections);
+	NotifyConnections(PendingConnections);
 }
 
 // Since we listen to global (static) events, we need to watch out for cross world broadcasts (PIE)
@@ -571,106 +1043,158 @@ void UShooterReplicationGraph::OnGameplayDebuggerOwnerChange(AGameplayDebuggerCa
 
 // ------------------------------------------------------------------------------
 
-void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState()
+void UShooterReplicationGraphNode_GridSpatialization2D::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
-	AlwaysRelevantStreamingLevelsNeedingReplication.Empty();
+	FShooterRepGraphTelemetry::FScopedGather TelemetryScope(CastChecked<UShooterReplicationGraph>(GetOuter())->Telemetry, GridName);
+
+	// the cells' lists are added straight to Params, so what the grid handed out is the difference
+	const int32 NumActorsBefore = FShooterRepGraphTelemetry::IsEnabled() ? FShooterRepGraphTelemetry::CountActors(Params.OutGatheredReplicationLists) : 0;
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+
+	Super::GatherActorListsForConnection(Params);
+
+	const uint32 Cycles = FPlatformTime::Cycles() - StartCycles;
+
+	if (FShooterRepGraphTelemetry::IsEnabled())
+	{
+		TelemetryScope.NumActors = FShooterRepGraphTelemetry::CountActors(Params.OutGatheredReplicationLists) - NumActorsBefore;
+	}
+
+	GatherCycles += Cycles;
+	MaxGatherCycles = FMath::Max<uint64>(MaxGatherCycles, Cycles);
+	++NumGathers;
 }
 
-void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+void UShooterReplicationGraphNode_GridSpatialization2D::PrepareForReplication()
 {
-	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_AlwaysRelevant_ForConnection_GatherActorListsForConnection );
+	const uint32 StartCycles = FPlatformTime::Cycles();
 
-	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
-
-	ReplicationActorList.Reset();
+	Super::PrepareForReplication();
 
-	auto ResetActorCullDistance = [&](AActor* ActorToSet, AActor*& LastActor) {
+	PrepareCycles += FPlatformTime::Cycles() - StartCycles;
+	++NumPrepares;
 
-		if (ActorToSet != LastActor)
+	if (CVar_ShooterRepGraph_GridTimingLogInterval > 0.f)
+	{
+		const double Now = FPlatformTime::Seconds();
+		if (LastLogTime == 0.0)
 		{
-			LastActor = ActorToSet;
-
-			UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Setting pawn cull distance to 0. %s"), *ActorToSet->GetName());
-			FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(ActorToSet);
-			ConnectionActorInfo.SetCullDistanceSquared(0.f);
+			LastLogTime = Now;
 		}
-	};
+		else if (Now - LastLogTime >= CVar_ShooterRepGraph_GridTimingLogInterval)
+		{
+			FlushTimings(bGridChanged ? TEXT("after grid change") : TEXT("periodic"));
+		}
+	}
+}
 
-	for (const FNetViewer& CurViewer : Params.Viewers)
+void UShooterReplicationGraphNode_GridSpatialization2D::FlushTimings(const TCHAR* Reason)
+{
+	if (NumGathers > 0 && NumPrepares > 0)
 	{
-		ReplicationActorList.ConditionalAdd(CurViewer.InViewer);
-		ReplicationActorList.ConditionalAdd(CurViewer.ViewTarget);
+		UE_LOG(LogShooterReplicationGraph, Display, TEXT("%s timings (%s, CellSize %.0f, Bias %s): %d gathers avg %.2fus max %.2fus, %d prepares avg %.2fus"),
+			*GridName.ToString(), Reason, CellSize, *SpatialBias.ToString(),
+			NumGathers, FPlatformTime::ToMilliseconds64(GatherCycles) * 1000.0 / NumGathers, FPlatformTime::ToMilliseconds64(MaxGatherCycles) * 1000.0,
+			NumPrepares, FPlatformTime::ToMilliseconds64(PrepareCycles) * 1000.0 / NumPrepares);
+	}
 
-		if (AShooterPlayerController* PC = Cast<AShooterPlayerController>(CurViewer.InViewer))
-		{
-			// 50% throttling of PlayerStates.
-			const bool bReplicatePS = (Params.ConnectionManager.ConnectionId % 2) == (Params.ReplicationFrameNum % 2);
-			if (bReplicatePS)
-			{
-				// Always return the player state to the owning player. Simulated proxy player states are handled by UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
-				if (APlayerState* PS = PC->PlayerState)
-				{
-					if (!bInitializedPlayerState)
-					{
-						bInitializedPlayerState = true;
-						FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(PS);
-						ConnectionActorInfo.ReplicationPeriodFrame = 1;
-					}
+	GatherCycles = 0;
+	MaxGatherCycles = 0;
+	NumGathers = 0;
+	PrepareCycles = 0;
+	NumPrepares = 0;
+	LastLogTime = FPlatformTime::Seconds();
+	bGridChanged = false;
+}
 
-					ReplicationActorList.ConditionalAdd(PS);
-				}
-			}
+void UShooterReplicationGraphNode_GridSpatialization2D::SetGrid(float InCellSize, const FVector2D& InSpatialBias)
+{
+	FlushTimings(TEXT("before grid change"));
 
-			FAlwaysRelevantActorInfo* LastData = PastRelevantActors.FindByKey<UNetConnection*>(CurViewer.Connection);
+	CellSize = InCellSize;
+	SpatialBias = InSpatialBias;
+	bGridChanged = true;
+}
 
-			// We've not seen this actor before, go ahead and add them.
-			if (LastData == nullptr)
-			{
-				FAlwaysRelevantActorInfo NewActorInfo;
-				NewActorInfo.Connection = CurViewer.Connection;
-				LastData = &(PastRelevantActors[PastRelevantActors.Add(NewActorInfo)]);
-			}
+// ------------------------------------------------------------------------------
 
-			check(LastData != nullptr);
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState()
+{
+	VisibleStreamingLevels.Empty();
+	AlwaysRelevantStreamingLevelsNeedingReplication.Empty();
+}
+
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_AlwaysRelevant_ForConnection_GatherActorListsForConnection );
+
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+
+	FShooterRepGraphTelemetry::FScopedGather TelemetryScope(ShooterGraph->Telemetry, TEXT("AlwaysRelevant_ForConnection"));
+	if (FShooterRepGraphTelemetry::IsEnabled())
+	{
+		RecordStarvation(Params);
+	}
+
+	// Collect what should be in the list. This is only a handful of pointers, the list itself (and the per connection settings) is only touched when they change.
+	TArray<TWeakObjectPtr<AActor>, TInlineAllocator<16> > CurrentRelevantActors;
+
+	for (const FNetViewer& CurViewer : Params.Viewers)
+	{
+		CurrentRelevantActors.AddUnique(CurViewer.InViewer);
+		CurrentRelevantActors.AddUnique(CurViewer.ViewTarget);
+
+		if (AShooterPlayerController* PC = Cast<AShooterPlayerController>(CurViewer.InViewer))
+		{
+			CurrentRelevantActors.AddUnique(PC->PlayerState);
 
 			if (AShooterCharacter* Pawn = Cast<AShooterCharacter>(PC->GetPawn()))
 			{
-				ResetActorCullDistance(Pawn, LastData->LastViewer);
-
-				if (Pawn != CurViewer.ViewTarget)
-				{
-					ReplicationActorList.ConditionalAdd(Pawn);
-				}
+				CurrentRelevantActors.AddUnique(Pawn);
 
 				int32 InventoryCount = Pawn->GetInventoryCount();
 				for (int32 i = 0; i < InventoryCount; ++i)
 				{
-					AShooterWeapon* Weapon = Pawn->GetInventoryWeapon(i);
-					if (Weapon)
-					{
-						ReplicationActorList.ConditionalAdd(Weapon);
-					}
+					CurrentRelevantActors.AddUnique(Pawn->GetInventoryWeapon(i));
 				}
 			}
-
-			if (AShooterCharacter* ViewTargetPawn = Cast<AShooterCharacter>(CurViewer.ViewTarget))
-			{
-				ResetActorCullDistance(ViewTargetPawn, LastData->LastViewTarget);
-			}
 		}
 	}
 
-	PastRelevantActors.RemoveAll([&](FAlwaysRelevantActorInfo& RelActorInfo) {
-		return RelActorInfo.Connection == nullptr;
-	});
+#if WITH_GAMEPLAY_DEBUGGER
+	CurrentRelevantActors.AddUnique(GameplayDebugger);
+#endif
+
+	CurrentRelevantActors.RemoveAll([](const TWeakObjectPtr<AActor>& Actor) { return !Actor.IsValid(); });
+
+	if (CurrentRelevantActors != RelevantActors || ReplicationActorList.IsValid() == false)
+	{
+		RelevantActors = CurrentRelevantActors;
+		RebuildReplicationActorList(Params);
+	}
 
 	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+	TelemetryScope.NumActors += ReplicationActorList.Num();
+
+	// 50% throttling of PlayerStates.
+	const bool bReplicatePS = (Params.ConnectionManager.ConnectionId % 2) == (Params.ReplicationFrameNum % 2);
+	if (bReplicatePS && PlayerStateList.IsValid() && PlayerStateList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(PlayerStateList);
+		TelemetryScope.NumActors += PlayerStateList.Num();
+	}
 
 	// Always relevant streaming level actors.
 	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
 	
 	TMap<FName, FActorRepListRefView>& AlwaysRelevantStreamingLevelActors = ShooterGraph->AlwaysRelevantStreamingLevelActors;
 
+	// Levels stay in the list until everything in them is dormant for this connection. That is rare enough that it is only checked every few frames,
+	// spread over connections. OnStreamingLevelActorsChanged puts a level back when one of its actors wakes up.
+	const uint32 CheckPeriod = (uint32)FMath::Max(CVar_ShooterRepGraph_AlwaysRelevantLevelCheckPeriod, 1);
+	const bool bCheckDormancy = ((Params.ReplicationFrameNum + Params.ConnectionManager.ConnectionId) % CheckPeriod) == 0;
+
 	for (int32 Idx=AlwaysRelevantStreamingLevelsNeedingReplication.Num()-1; Idx >= 0; --Idx)
 	{
 		const FName& StreamingLevel = AlwaysRelevantStreamingLevelsNeedingReplication[Idx];
@@ -688,14 +1212,20 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 
 		if (RepList.Num() > 0)
 		{
-			bool bAllDormant = true;
-			for (FActorRepListType Actor : RepList)
+			bool bAllDormant = false;
+			if (bCheckDormancy)
 			{
-				FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
-				if (ConnectionActorInfo.bDormantOnConnection == false)
+				INC_DWORD_STAT(STAT_ShooterRepGraph_AlwaysRelevantLevelChecks);
+
+				bAllDormant = true;
+				for (FActorRepListType Actor : RepList)
 				{
-					bAllDormant = false;
-					break;
+					FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
+					if (ConnectionActorInfo.bDormantOnConnection == false)
+					{
+						bAllDormant = false;
+						break;
+					}
 				}
 			}
 
@@ -706,8 +1236,8 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 			}
 			else
 			{
-				UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING Adding always Actors on StreamingLevel %s for %s because it has at least one non dormant actor"), *StreamingLevel.ToString(), *Params.ConnectionManager.GetName());
 				Params.OutGatheredReplicationLists.AddReplicationActorList(RepList);
+				TelemetryScope.NumActors += RepList.Num();
 			}
 		}
 		else
@@ -716,32 +1246,135 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorLists
 		}
 
 	}
+}
 
-#if WITH_GAMEPLAY_DEBUGGER
-	if (GameplayDebugger)
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::RebuildReplicationActorList(const FConnectionGatherActorListParameters& Params)
+{
+	INC_DWORD_STAT(STAT_ShooterRepGraph_AlwaysRelevantRebuilds);
+
+	ReplicationActorList.PrepareForWrite();
+	ReplicationActorList.Reset();
+	PlayerStateList.PrepareForWrite();
+	PlayerStateList.Reset();
+
+	auto ResetActorCullDistance = [&](AActor* ActorToSet, AActor*& LastActor) {
+
+		if (ActorToSet != LastActor)
+		{
+			LastActor = ActorToSet;
+
+			UE_LOG(LogShooterReplicationGraph, Verbose, TEXT("Setting pawn cull distance to 0. %s"), *ActorToSet->GetName());
+			FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(ActorToSet);
+			ConnectionActorInfo.SetCullDistanceSquared(0.f);
+		}
+	};
+
+	for (const FNetViewer& CurViewer : Params.Viewers)
+	{
+		if (AShooterPlayerController* PC = Cast<AShooterPlayerController>(CurViewer.InViewer))
+		{
+			// Always return the player state to the owning player. Simulated proxy player states are handled by UShooterReplicationGraphNode_PlayerStateFrequencyLimiter
+			if (APlayerState* PS = PC->PlayerState)
+			{
+				if (!bInitializedPlayerState)
+				{
+					bInitializedPlayerState = true;
+					FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(PS);
+					ConnectionActorInfo.ReplicationPeriodFrame = 1;
+				}
+
+				PlayerStateList.ConditionalAdd(PS);
+			}
+
+			FAlwaysRelevantActorInfo* LastData = PastRelevantActors.FindByKey<UNetConnection*>(CurViewer.Connection);
+
+			// We've not seen this actor before, go ahead and add them.
+			if (LastData == nullptr)
+			{
+				FAlwaysRelevantActorInfo NewActorInfo;
+				NewActorInfo.Connection = CurViewer.Connection;
+				LastData = &(PastRelevantActors[PastRelevantActors.Add(NewActorInfo)]);
+			}
+
+			check(LastData != nullptr);
+
+			if (AShooterCharacter* Pawn = Cast<AShooterCharacter>(PC->GetPawn()))
+			{
+				ResetActorCullDistance(Pawn, LastData->LastViewer);
+			}
+
+			if (AShooterCharacter* ViewTargetPawn = Cast<AShooterCharacter>(CurViewer.ViewTarget))
+			{
+				ResetActorCullDistance(ViewTargetPawn, LastData->LastViewTarget);
+			}
+		}
+	}
+
+	// Everything but the PlayerStates, which are throttled separately
+	for (const TWeakObjectPtr<AActor>& RelevantActor : RelevantActors)
+	{
+		AActor* Actor = RelevantActor.Get();
+		if (PlayerStateList.Contains(Actor) == false)
+		{
+			ReplicationActorList.Add(Actor);
+		}
+	}
+
+	PastRelevantActors.RemoveAll([&](FAlwaysRelevantActorInfo& RelActorInfo) {
+		return RelActorInfo.Connection == nullptr;
+	});
+}
+
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::RecordStarvation(const FConnectionGatherActorListParameters& Params) const
+{
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+	if (ShooterGraph->PVSNode == nullptr)
 	{
-		ReplicationActorList.ConditionalAdd(GameplayDebugger);
+		return;
+	}
+
+	// Pawns with an open channel are the ones the player can see and cares about. Actors without a channel aren't relevant, their staleness means nothing.
+	for (FActorRepListType Actor : ShooterGraph->PVSNode->GetAllActors())
+	{
+		if (const FConnectionReplicationActorInfo* ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.Find(Actor))
+		{
+			if (ConnectionActorInfo->Channel && Params.ReplicationFrameNum > ConnectionActorInfo->LastRepFrameNum)
+			{
+				ShooterGraph->Telemetry.RecordStarvation(Params.ConnectionManager, Params.ReplicationFrameNum - ConnectionActorInfo->LastRepFrameNum);
+			}
+		}
 	}
-#endif
 }
 
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd(FName LevelName, UWorld* StreamingWorld)
 {
 	UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING ::OnClientLevelVisibilityAdd - %s"), *LevelName.ToString());
-	AlwaysRelevantStreamingLevelsNeedingReplication.Add(LevelName);
+	VisibleStreamingLevels.AddUnique(LevelName);
+	AlwaysRelevantStreamingLevelsNeedingReplication.AddUnique(LevelName);
 }
 
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove(FName LevelName)
 {
 	UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING ::OnClientLevelVisibilityRemove - %s"), *LevelName.ToString());
+	VisibleStreamingLevels.Remove(LevelName);
 	AlwaysRelevantStreamingLevelsNeedingReplication.Remove(LevelName);
 }
 
+void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::OnStreamingLevelActorsChanged(FName LevelName)
+{
+	if (VisibleStreamingLevels.Contains(LevelName) && !AlwaysRelevantStreamingLevelsNeedingReplication.Contains(LevelName))
+	{
+		UE_CLOG(CVar_ShooterRepGraph_DisplayClientLevelStreaming > 0, LogShooterReplicationGraph, Display, TEXT("CLIENTSTREAMING ::OnStreamingLevelActorsChanged - %s"), *LevelName.ToString());
+		AlwaysRelevantStreamingLevelsNeedingReplication.Add(LevelName);
+	}
+}
+
 void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
 {
 	DebugInfo.Log(NodeName);
 	DebugInfo.PushIndent();
 	LogActorRepList(DebugInfo, NodeName, ReplicationActorList);
+	LogActorRepList(DebugInfo, TEXT("PlayerStates"), PlayerStateList);
 
 	for (const FName& LevelName : AlwaysRelevantStreamingLevelsNeedingReplication)
 	{
@@ -757,52 +1390,258 @@ void UShooterReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplica
 
 // ------------------------------------------------------------------------------
 
+void UShooterReplicationGraphNode_ViewPriority_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_ViewPriority_ForConnection_GatherActorListsForConnection );
+
+	UShooterReplicationGraph* ShooterGraph = CastChecked<UShooterReplicationGraph>(GetOuter());
+	FShooterRepGraphTelemetry::FScopedGather TelemetryScope(ShooterGraph->Telemetry, TEXT("ViewPriority_ForConnection"));
+	if (ShooterGraph->PVSNode == nullptr)
+	{
+		return;
+	}
+
+	const FActorRepListRefView& Pawns = ShooterGraph->PVSNode->GetAllActors();
+	FGlobalActorReplicationInfoMap& GlobalInfoMap = *GraphGlobals->GlobalActorReplicationInfoMap;
+
+	if (!CVar_ShooterRepGraph_ViewPriority)
+	{
+		// Put the class defaults back once, after that leave the connection alone
+		if (bAppliedPeriods)
+		{
+			bAppliedPeriods = false;
+			for (FActorRepListType Actor : Pawns)
+			{
+				Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor).ReplicationPeriodFrame = GlobalInfoMap.Get(Actor).Settings.ReplicationPeriodFrame;
+			}
+		}
+		return;
+	}
+
+	bAppliedPeriods = true;
+
+	// Pawns that are always interesting regardless of where the viewer looks
+	TArray<AActor*, TInlineAllocator<4>> FullRatePawns;
+	for (const FNetViewer& CurViewer : Params.Viewers)
+	{
+		FullRatePawns.Add(CurViewer.ViewTarget);
+		if (CurViewer.InViewer)
+		{
+			FullRatePawns.Add(CurViewer.InViewer->GetPawn());
+		}
+
+		if (AShooterCharacter* ViewTargetPawn = Cast<AShooterCharacter>(CurViewer.ViewTarget))
+		{
+			FullRatePawns.Add(ViewTargetPawn->GetRecentAttacker(CVar_ShooterRepGraph_ViewPriorityAttackerTime));
+
+			// Spectating a bot: whoever it is after is about to be on screen
+			if (AShooterAIController* AIController = Cast<AShooterAIController>(ViewTargetPawn->GetController()))
+			{
+				FullRatePawns.Add(AIController->GetEnemy());
+			}
+		}
+	}
+
+	const float CosHalfFOV = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(CVar_ShooterRepGraph_ViewPriorityFOV, 1.f, 360.f) * 0.5f));
+	const uint32 OffScreenScale = (uint32)FMath::Max(CVar_ShooterRepGraph_ViewPriorityOffScreenScale, 1);
+	const uint32 BehindScale = (uint32)FMath::Max(CVar_ShooterRepGraph_ViewPriorityBehindScale, 1);
+
+	for (FActorRepListType Actor : Pawns)
+	{
+		uint32 Scale = 1;
+		if (!FullRatePawns.Contains(Actor))
+		{
+			// Best angle over all viewers (split screen)
+			float BestDot = -1.f;
+			for (const FNetViewer& CurViewer : Params.Viewers)
+			{
+				const FVector ToActor = (Actor->GetActorLocation() - CurViewer.ViewLocation).GetSafeNormal();
+				BestDot = FMath::Max(BestDot, FVector::DotProduct(CurViewer.ViewDir, ToActor));
+			}
+
+			Scale = (BestDot >= CosHalfFOV) ? 1 : (BestDot >= 0.f ? OffScreenScale : BehindScale);
+		}
+
+		if (Scale == 1)
+		{
+			INC_DWORD_STAT(STAT_ShooterRepGraph_ViewPriorityFull);
+		}
+		else if (Scale == OffScreenScale)
+		{
+			INC_DWORD_STAT(STAT_ShooterRepGraph_ViewPriorityOffScreen);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_ShooterRepGraph_ViewPriorityBehind);
+		}
+
+		FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor);
+		ConnectionActorInfo.ReplicationPeriodFrame = GlobalInfoMap.Get(Actor).Settings.ReplicationPeriodFrame * Scale;
+
+		// A pawn that just came on screen shouldn't wait out the longer period it was last scheduled with
+		ConnectionActorInfo.NextReplicationFrameNum = FMath::Min(ConnectionActorInfo.NextReplicationFrameNum, ConnectionActorInfo.LastRepFrameNum + ConnectionActorInfo.ReplicationPeriodFrame);
+	}
+}
+
+void UShooterReplicationGraphNode_ViewPriority_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(FString::Printf(TEXT("%s (%s)"), *NodeName, CVar_ShooterRepGraph_ViewPriority ? TEXT("Enabled") : TEXT("Disabled")));
+}
+
+// ------------------------------------------------------------------------------
+
 UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::UShooterReplicationGraphNode_PlayerStateFrequencyLimiter()
 {
 	bRequiresPrepareForReplicationCall = true;
+	BucketSize = FMath::Max(TargetActorsPerFrame, 1);
 }
 
-void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
 {
-	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_PlayerStateFrequencyLimiter_GlobalPrepareForReplication );
+	// Append to the last bucket. Every other bucket is full so the lists stay compact without touching anything else.
+	if (ReplicationActorLists.Num() == 0 || ReplicationActorLists.Last().Num() >= BucketSize)
+	{
+		ReplicationActorLists.AddDefaulted();
+	}
+
+	FActorRepListRefView& List = ReplicationActorLists.Last();
+	List.PrepareForWrite();
+	List.Add(ActorInfo.Actor);
+
+	INC_DWORD_STAT(STAT_ShooterRepGraph_PlayerStatesTracked);
+}
+
+bool UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	for (FActorRepListRefView& List : ReplicationActorLists)
+	{
+		if (List.Remove(ActorInfo.Actor))
+		{
+			// Leave the hole for now. Compacting here would mean reshuffling the buckets once per leaving player if several leave on the same frame.
+			bNeedsDefrag = true;
+			DEC_DWORD_STAT(STAT_ShooterRepGraph_PlayerStatesTracked);
+			return true;
+		}
+	}
 
+	UE_CLOG(bWarnIfNotFound, LogShooterReplicationGraph, Warning, TEXT("UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyRemoveNetworkActor - %s not found"), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+	return false;
+}
+
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyResetAllNetworkActors()
+{
 	ReplicationActorLists.Reset();
 	ForceNetUpdateReplicationActorList.Reset();
+	ValidActorList.Reset();
+	bNeedsDefrag = false;
+	bCheckedBucket = false;
+	bUseValidActorList = false;
 
-	ReplicationActorLists.AddDefaulted();
-	FActorRepListRefView* CurrentList = &ReplicationActorLists[0];
-	CurrentList->PrepareForWrite();
-
-	// We rebuild our lists of player states each frame. This is not as efficient as it could be but its the simplest way
-	// to handle players disconnecting and keeping the lists compact. If the lists were persistent we would need to defrag them as players left.
+	SET_DWORD_STAT(STAT_ShooterRepGraph_PlayerStatesTracked, 0);
+	SET_DWORD_STAT(STAT_ShooterRepGraph_PlayerStateBuckets, 0);
+}
 
-	for (TActorIterator<APlayerState> It(GetWorld()); It; ++It)
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::RebuildBuckets()
+{
+	TArray<FActorRepListType, TInlineAllocator<128>> PlayerStates;
+	for (const FActorRepListRefView& List : ReplicationActorLists)
 	{
-		APlayerState* PS = *It;
-		if (IsActorValidForReplicationGather(PS) == false)
+		for (FActorRepListType Actor : List)
 		{
-			continue;
+			PlayerStates.Add(Actor);
 		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_ShooterRepGraph_PlayerStatesVisited, PlayerStates.Num());
+	INC_DWORD_STAT(STAT_ShooterRepGraph_PlayerStateRebuilds);
+
+	BucketSize = FMath::Max(TargetActorsPerFrame, 1);
+	ReplicationActorLists.Reset();
 
-		if (CurrentList->Num() >= TargetActorsPerFrame)
+	for (FActorRepListType Actor : PlayerStates)
+	{
+		if (ReplicationActorLists.Num() == 0 || ReplicationActorLists.Last().Num() >= BucketSize)
 		{
 			ReplicationActorLists.AddDefaulted();
-			CurrentList = &ReplicationActorLists.Last(); 
-			CurrentList->PrepareForWrite();
+			ReplicationActorLists.Last().PrepareForWrite();
 		}
-		
-		CurrentList->Add(PS);
-	}	
+
+		ReplicationActorLists.Last().Add(Actor);
+	}
+
+	bNeedsDefrag = false;
+}
+
+void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_PlayerStateFrequencyLimiter_GlobalPrepareForReplication );
+
+	ForceNetUpdateReplicationActorList.Reset();
+	bCheckedBucket = false;
+
+	// The buckets are persistent and only touched here when a player state left (leaving a hole) or the bucket size changed.
+	// On every other frame this is O(1) regardless of the number of players.
+	if (bNeedsDefrag || BucketSize != FMath::Max(TargetActorsPerFrame, 1))
+	{
+		RebuildBuckets();
+	}
+
+	// Always have at least one (possibly empty) list to hand out
+	if (ReplicationActorLists.Num() == 0)
+	{
+		ReplicationActorLists.AddDefaulted();
+		ReplicationActorLists.Last().PrepareForWrite();
+	}
+
+	SET_DWORD_STAT(STAT_ShooterRepGraph_PlayerStateBuckets, ReplicationActorLists.Num());
 }
 
 void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	FShooterRepGraphTelemetry::FScopedGather TelemetryScope(CastChecked<UShooterReplicationGraph>(GetOuter())->Telemetry, TEXT("PlayerStateFrequencyLimiter"));
+
 	const int32 ListIdx = Params.ReplicationFrameNum % ReplicationActorLists.Num();
-	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[ListIdx]);
+	const FActorRepListRefView& Bucket = ReplicationActorLists[ListIdx];
+
+	// Every connection gets the same bucket this frame, so only the first one checks it. Player states stay in the buckets until they
+	// are removed from the graph, which for a torn off one may be a while. Only the bucket handed out is checked, not all of them.
+	if (!bCheckedBucket)
+	{
+		bCheckedBucket = true;
+		bUseValidActorList = false;
+
+		for (FActorRepListType Actor : Bucket)
+		{
+			if (!IsActorValidForReplicationGather(Actor) || Actor->GetTearOff())
+			{
+				bUseValidActorList = true;
+				break;
+			}
+		}
+
+		if (bUseValidActorList)
+		{
+			ValidActorList.PrepareForWrite();
+			ValidActorList.Reset();
+
+			for (FActorRepListType Actor : Bucket)
+			{
+				if (IsActorValidForReplicationGather(Actor) && !Actor->GetTearOff())
+				{
+					ValidActorList.Add(Actor);
+				}
+			}
+		}
+	}
+
+	const FActorRepListRefView& List = bUseValidActorList ? ValidActorList : Bucket;
+	Params.OutGatheredReplicationLists.AddReplicationActorList(List);
+	TelemetryScope.NumActors = List.Num();
 
 	if (ForceNetUpdateReplicationActorList.Num() > 0)
 	{
 		Params.OutGatheredReplicationLists.AddReplicationActorList(ForceNetUpdateReplicationActorList);
+		TelemetryScope.NumActors += ForceNetUpdateReplicationActorList.Num();
 	}	
 }
 
@@ -822,9 +1661,311 @@ void UShooterReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplicat
 
 // ------------------------------------------------------------------------------
 
-void UShooterReplicationGraph::PrintRepNodePolicies()
+UShooterReplicationGraphNode_PVS::UShooterReplicationGraphNode_PVS()
 {
-	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UShooterReplicationGraphNode_PVS::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AllActors.PrepareForWrite();
+	AllActors.Add(ActorInfo.Actor);
+	NewActors.Add(ActorInfo.Actor);
+}
+
+bool UShooterReplicationGraphNode_PVS::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	// Removing swaps the last actor into the hole, so ActorCells holds its actor instead of an index into AllActors.
+	// The entry is only cleared here and dropped by the next PrepareForReplication.
+	if (AllActors.Remove(ActorInfo.Actor))
+	{
+		for (FActorCell& ActorCell : ActorCells)
+		{
+			if (ActorCell.Actor == ActorInfo.Actor)
+			{
+				ActorCell.Actor = nullptr;
+				break;
+			}
+		}
+		NewActors.RemoveSingleSwap(ActorInfo.Actor, false);
+
+		return true;
+	}
+
+	UE_CLOG(bWarnIfNotFound, LogShooterReplicationGraph, Warning, TEXT("UShooterReplicationGraphNode_PVS::NotifyRemoveNetworkActor - %s not found"), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+	return false;
+}
+
+void UShooterReplicationGraphNode_PVS::NotifyResetAllNetworkActors()
+{
+	AllActors.Reset();
+	ActorCells.Reset();
+	NewActors.Reset();
+	CellLists.Reset();
+}
+
+void UShooterReplicationGraphNode_PVS::SetPVSData(UShooterPVSData* InPVSData)
+{
+	PVSData = (InPVSData && InPVSData->IsValid()) ? InPVSData : nullptr;
+
+	// Cell indices of the old table mean nothing with the new one
+	ActorCells.Reset();
+	CellLists.Reset();
+
+	NewActors.Reset();
+	for (FActorRepListType Actor : AllActors)
+	{
+		NewActors.Add(Actor);
+	}
+}
+
+void UShooterReplicationGraphNode_PVS::PrepareForReplication()
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_PVS_PrepareForReplication );
+
+	++CurrentFrame;
+
+	ActorCells.Reset();
+	NewActors.Reset();
+	if (PVSData)
+	{
+		for (FActorRepListType Actor : AllActors)
+		{
+			FActorCell& ActorCell = ActorCells.AddDefaulted_GetRef();
+			ActorCell.Actor = Actor;
+			ActorCell.Cell = PVSData->GetCellIndex(Actor->GetActorLocation());
+		}
+	}
+}
+
+void UShooterReplicationGraphNode_PVS::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_PVS_GatherActorListsForConnection );
+
+	FShooterRepGraphTelemetry::FScopedGather TelemetryScope(CastChecked<UShooterReplicationGraph>(GetOuter())->Telemetry, TEXT("PVS"));
+
+	if (AllActors.Num() == 0)
+	{
+		return;
+	}
+
+	for (const FNetViewer& CurViewer : Params.Viewers)
+	{
+		const int32 ViewerCell = PVSData ? PVSData->GetCellIndex(CurViewer.ViewLocation) : INDEX_NONE;
+		if (ViewerCell == INDEX_NONE)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(AllActors);
+			TelemetryScope.NumActors += AllActors.Num();
+			continue;
+		}
+
+		FCellList& CellList = CellLists.FindOrAdd(ViewerCell);
+		if (CellList.BuiltFrame != CurrentFrame)
+		{
+			CellList.BuiltFrame = CurrentFrame;
+			CellList.List.Reset();
+
+			for (const FActorCell& ActorCell : ActorCells)
+			{
+				if (ActorCell.Actor == nullptr)
+				{
+					// Removed after PrepareForReplication
+					continue;
+				}
+
+				if (ActorCell.Cell == INDEX_NONE || PVSData->IsCellVisible(ViewerCell, ActorCell.Cell))
+				{
+					CellList.List.Add(ActorCell.Actor);
+				}
+				else
+				{
+					INC_DWORD_STAT(STAT_ShooterRepGraph_PVSActorsCulled);
+				}
+			}
+
+			// Added after PrepareForReplication, we don't know where they are yet
+			for (FActorRepListType Actor : NewActors)
+			{
+				CellList.List.Add(Actor);
+			}
+
+			INC_DWORD_STAT(STAT_ShooterRepGraph_PVSCellListsBuilt);
+		}
+
+		if (CellList.List.Num() > 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(CellList.List);
+			TelemetryScope.NumActors += CellList.List.Num();
+		}
+	}
+}
+
+void UShooterReplicationGraphNode_PVS::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+
+	DebugInfo.Log(PVSData ? FString::Printf(TEXT("PVS: %s (%dx%dx%d cells)"), *PVSData->GetPathName(), PVSData->NumCells.X, PVSData->NumCells.Y, PVSData->NumCells.Z) : FString(TEXT("PVS: None")));
+	LogActorRepList(DebugInfo, TEXT("All"), AllActors);
+
+	for (const TPair<int32, FCellList>& CellList : CellLists)
+	{
+		if (CellList.Value.BuiltFrame == CurrentFrame)
+		{
+			LogActorRepList(DebugInfo, FString::Printf(TEXT("Cell[%d]"), CellList.Key), CellList.Value.List);
+		}
+	}
+
+	DebugInfo.PopIndent();
+}
+
+// ------------------------------------------------------------------------------
+
+UShooterReplicationGraphNode_Projectiles::UShooterReplicationGraphNode_Projectiles()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UShooterReplicationGraphNode_Projectiles::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AllProjectiles.PrepareForWrite();
+	AllProjectiles.Add(ActorInfo.Actor);
+	NewProjectiles.Add(ActorInfo.Actor);
+
+	INC_DWORD_STAT(STAT_ShooterRepGraph_ProjectilesTracked);
+}
+
+bool UShooterReplicationGraphNode_Projectiles::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	// Removing swaps the last projectile into the hole, so Sweeps holds its actor instead of an index into AllProjectiles.
+	// The sweep is only cleared here and dropped by the next PrepareForReplication.
+	if (AllProjectiles.Remove(ActorInfo.Actor))
+	{
+		for (FProjectileSweep& Sweep : Sweeps)
+		{
+			if (Sweep.Actor == ActorInfo.Actor)
+			{
+				Sweep.Actor = nullptr;
+				break;
+			}
+		}
+		NewProjectiles.RemoveSingleSwap(ActorInfo.Actor, false);
+
+		DEC_DWORD_STAT(STAT_ShooterRepGraph_ProjectilesTracked);
+		return true;
+	}
+
+	UE_CLOG(bWarnIfNotFound, LogShooterReplicationGraph, Warning, TEXT("UShooterReplicationGraphNode_Projectiles::NotifyRemoveNetworkActor - %s not found"), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+	return false;
+}
+
+void UShooterReplicationGraphNode_Projectiles::NotifyResetAllNetworkActors()
+{
+	AllProjectiles.Reset();
+	Sweeps.Reset();
+	NewProjectiles.Reset();
+	ConnectionLists.Reset();
+	NumConnectionListsUsed = 0;
+
+	SET_DWORD_STAT(STAT_ShooterRepGraph_ProjectilesTracked, 0);
+}
+
+void UShooterReplicationGraphNode_Projectiles::PrepareForReplication()
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_Projectiles_PrepareForReplication );
+
+	NumConnectionListsUsed = 0;
+
+	Sweeps.Reset();
+	NewProjectiles.Reset();
+	for (FActorRepListType Actor : AllProjectiles)
+	{
+		// Life span is what is left of ProjectileLife (or of the post explosion grace period). Exploded projectiles don't move and sweep a sphere.
+		const float RemainingLife = Actor->GetLifeSpan() > 0.f ? Actor->GetLifeSpan() : CVar_ShooterRepGraph_ProjectileMaxLookahead;
+		const float Lookahead = FMath::Min(RemainingLife, CVar_ShooterRepGraph_ProjectileMaxLookahead);
+
+		FProjectileSweep& Sweep = Sweeps.AddDefaulted_GetRef();
+		Sweep.Actor = Actor;
+		Sweep.Start = Actor->GetActorLocation();
+		Sweep.End = Sweep.Start + Actor->GetVelocity() * Lookahead;
+		Sweep.RadiusSquared = Actor->NetCullDistanceSquared;
+	}
+}
+
+void UShooterReplicationGraphNode_Projectiles::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	QUICK_SCOPE_CYCLE_COUNTER( UShooterReplicationGraphNode_Projectiles_GatherActorListsForConnection );
+
+	FShooterRepGraphTelemetry::FScopedGather TelemetryScope(CastChecked<UShooterReplicationGraph>(GetOuter())->Telemetry, TEXT("Projectiles"));
+
+	if (AllProjectiles.Num() == 0)
+	{
+		return;
+	}
+
+	// Lists handed out this frame must stay untouched until the next PrepareForReplication, so each connection gets its own
+	if (NumConnectionListsUsed == ConnectionLists.Num())
+	{
+		ConnectionLists.AddDefaulted();
+	}
+
+	FActorRepListRefView& List = ConnectionLists[NumConnectionListsUsed++];
+	List.Reset();
+
+	for (const FProjectileSweep& Sweep : Sweeps)
+	{
+		if (Sweep.Actor == nullptr)
+		{
+			// Removed after PrepareForReplication
+			continue;
+		}
+
+		bool bRelevant = false;
+		for (const FNetViewer& CurViewer : Params.Viewers)
+		{
+			if (FMath::PointDistToSegmentSquared(CurViewer.ViewLocation, Sweep.Start, Sweep.End) <= Sweep.RadiusSquared)
+			{
+				bRelevant = true;
+				break;
+			}
+		}
+
+		if (bRelevant)
+		{
+			List.Add(Sweep.Actor);
+		}
+	}
+
+	// Added after PrepareForReplication, we don't know where they are headed yet
+	for (FActorRepListType Actor : NewProjectiles)
+	{
+		List.Add(Actor);
+	}
+
+	TelemetryScope.NumActors = List.Num();
+
+	INC_DWORD_STAT_BY(STAT_ShooterRepGraph_ProjectilesGathered, List.Num());
+	INC_DWORD_STAT_BY(STAT_ShooterRepGraph_ProjectilesCulled, AllProjectiles.Num() - List.Num());
+
+	if (List.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(List);
+	}
+}
+
+void UShooterReplicationGraphNode_Projectiles::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	LogActorRepList(DebugInfo, TEXT("All"), AllProjectiles);
+	DebugInfo.PopIndent();
+}
+
+// ------------------------------------------------------------------------------
+
+void UShooterReplicationGraph::PrintRepNodePolicies()
+{
+	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
 	if (!Enum)
 	{
 		return;
@@ -871,3 +2012,193 @@ FAutoConsoleCommandWithWorldAndArgs ChangeFrequencyBucketsCmd(TEXT("ShooterRepGr
 		Node->SetNonStreamingCollectionSize(Buckets);
 	}
 }));
+
+// ------------------------------------------------------------------------------
+
+FAutoConsoleCommandWithWorldAndArgs ShooterBakePVSCmd(TEXT("ShooterRepGraph.PVS.Bake"), TEXT("Bakes the potential visibility table of the current map and applies it to the running replication graph. Saved to /Game/Maps/PVS in editor builds. Args: <CellSize=2000> <SamplesPerCell=4> <MaxTraceDistance=15000>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (World == nullptr)
+		{
+			return;
+		}
+
+		float CellSize = 2000.f;
+		int32 SamplesPerCell = 4;
+		float MaxTraceDistance = 15000.f;
+
+		if (Args.Num() > 0)
+		{
+			LexTryParseString<float>(CellSize, *Args[0]);
+		}
+		if (Args.Num() > 1)
+		{
+			LexTryParseString<int32>(SamplesPerCell, *Args[1]);
+		}
+		if (Args.Num() > 2)
+		{
+			LexTryParseString<float>(MaxTraceDistance, *Args[2]);
+		}
+
+		const FString PackageName = UShooterPVSData::GetPackageNameForMap(UWorld::RemovePIEPrefix(World->GetOutermost()->GetName()));
+		const FString AssetName = FPackageName::GetShortName(PackageName);
+
+#if WITH_EDITOR
+		UPackage* Package = CreatePackage(nullptr, *PackageName);
+		UShooterPVSData* PVSData = FindObject<UShooterPVSData>(Package, *AssetName);
+		if (PVSData == nullptr)
+		{
+			PVSData = NewObject<UShooterPVSData>(Package, *AssetName, RF_Public | RF_Standalone);
+			FAssetRegistryModule::AssetCreated(PVSData);
+		}
+#else
+		UShooterPVSData* PVSData = NewObject<UShooterPVSData>(GetTransientPackage(), *AssetName);
+#endif
+
+		PVSData->Build(World, CellSize, SamplesPerCell, MaxTraceDistance);
+		if (!PVSData->IsValid())
+		{
+			return;
+		}
+
+#if WITH_EDITOR
+		Package->MarkPackageDirty();
+		const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+		if (UPackage::SavePackage(Package, PVSData, RF_Public | RF_Standalone, *Filename))
+		{
+			UE_LOG(LogShooterReplicationGraph, Display, TEXT("Saved PVS table to %s"), *Filename);
+		}
+		else
+		{
+			UE_LOG(LogShooterReplicationGraph, Error, TEXT("Failed to save PVS table to %s"), *Filename);
+		}
+#else
+		UE_LOG(LogShooterReplicationGraph, Warning, TEXT("PVS table can only be saved from editor builds, it is only applied to the running server"));
+#endif
+
+		for (TObjectIterator<UShooterReplicationGraph> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->PVSNode)
+			{
+				It->PVSNode->SetPVSData(PVSData);
+			}
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs ShooterDrawPVSCmd(TEXT("ShooterRepGraph.PVS.Draw"), TEXT("Draws the PVS cells around the local view: yellow is the viewer cell, green is visible from it, red is culled. Args: <RadiusInCells=3> <Duration=10>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+		if (PC == nullptr)
+		{
+			return;
+		}
+
+		int32 Radius = 3;
+		float Duration = 10.f;
+
+		if (Args.Num() > 0)
+		{
+			LexTryParseString<int32>(Radius, *Args[0]);
+		}
+		if (Args.Num() > 1)
+		{
+			LexTryParseString<float>(Duration, *Args[1]);
+		}
+
+		// Prefer the table the server is using, fall back to loading it (e.g. on a client)
+		UShooterPVSData* PVSData = nullptr;
+		for (TObjectIterator<UShooterReplicationGraph> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->PVSNode && It->PVSNode->PVSData)
+			{
+				PVSData = It->PVSNode->PVSData;
+				break;
+			}
+		}
+
+		if (PVSData == nullptr)
+		{
+			PVSData = UShooterPVSData::LoadForWorld(World);
+		}
+
+		if (PVSData == nullptr)
+		{
+			UE_LOG(LogShooterReplicationGraph, Display, TEXT("No PVS table for %s"), *World->GetOutermost()->GetName());
+			return;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		const int32 ViewerCell = PVSData->GetCellIndex(ViewLocation);
+		if (ViewerCell == INDEX_NONE)
+		{
+			UE_LOG(LogShooterReplicationGraph, Display, TEXT("View location %s is outside of the PVS table"), *ViewLocation.ToString());
+			return;
+		}
+
+		const FVector ViewerCellCenter = PVSData->GetCellBounds(ViewerCell).GetCenter();
+		const FVector BoxExtent(PVSData->CellSize * 0.45f);
+
+		for (int32 Z = -Radius; Z <= Radius; ++Z)
+		{
+			for (int32 Y = -Radius; Y <= Radius; ++Y)
+			{
+				for (int32 X = -Radius; X <= Radius; ++X)
+				{
+					const FVector CellCenter = ViewerCellCenter + FVector(X, Y, Z) * PVSData->CellSize;
+					const int32 Cell = PVSData->GetCellIndex(CellCenter);
+					if (Cell == INDEX_NONE)
+					{
+						continue;
+					}
+
+					const FColor Color = (Cell == ViewerCell) ? FColor::Yellow : (PVSData->IsCellVisible(ViewerCell, Cell) ? FColor::Green : FColor::Red);
+					DrawDebugBox(World, CellCenter, BoxExtent, Color, false, Duration);
+				}
+			}
+		}
+	})
+);
+
+// ------------------------------------------------------------------------------
+
+FAutoConsoleCommandWithWorldAndArgs ShooterDumpTelemetryCmd(TEXT("ShooterRepGraph.Telemetry.Dump"), TEXT("Writes the counters collected while ShooterRepGraph.Telemetry is set to a CSV. Args: <Filename=Profiling/RepGraph/ShooterRepGraph-<timestamp>.csv>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const FString BaseFilename = Args.Num() > 0 ? Args[0] : FPaths::ProfilingDir() / TEXT("RepGraph") / FString::Printf(TEXT("ShooterRepGraph-%s.csv"), *FDateTime::Now().ToString());
+
+		int32 GraphIdx = 0;
+		for (TObjectIterator<UShooterReplicationGraph> It; It; ++It)
+		{
+			if (It->HasAnyFlags(RF_ClassDefaultObject))
+			{
+				continue;
+			}
+
+			// More than one graph only happens in PIE with several servers, keep them apart
+			const FString Filename = (GraphIdx++ == 0) ? BaseFilename : FPaths::SetExtension(FString::Printf(TEXT("%s_%d"), *FPaths::ChangeExtension(BaseFilename, TEXT("")), GraphIdx), TEXT("csv"));
+			if (It->Telemetry.WriteCSV(Filename))
+			{
+				UE_LOG(LogShooterReplicationGraph, Display, TEXT("Wrote replication graph telemetry to %s"), *Filename);
+			}
+			else
+			{
+				UE_LOG(LogShooterReplicationGraph, Warning, TEXT("Failed to write replication graph telemetry to %s"), *Filename);
+			}
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs ShooterResetTelemetryCmd(TEXT("ShooterRepGraph.Telemetry.Reset"), TEXT("Resets the replication graph telemetry counters"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<UShooterReplicationGraph> It; It; ++It)
+		{
+			It->Telemetry.Reset();
+		}
+	})
+);
@@ -4,12 +4,18 @@
 
 #include "CoreMinimal.h"
 #include "ReplicationGraph.h"
+#include "ShooterReplicationGraphTelemetry.h"
+#include "ShooterReplicationGraphGovernor.h"
 #include "ShooterReplicationGraph.generated.h"
 
 class AShooterCharacter;
 class AShooterWeapon;
 class UReplicationGraphNode_GridSpatialization2D;
 class AGameplayDebuggerCategoryReplicator;
+class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter;
+class UShooterReplicationGraphNode_PVS;
+class UShooterReplicationGraphNode_Projectiles;
+class UShooterPVSData;
 
 DECLARE_LOG_CATEGORY_EXTERN( LogShooterReplicationGraph, Display, All );
 
@@ -22,9 +28,11 @@ enum class EClassRepNodeMapping : uint32
 	
 	// ONLY SPATIALIZED Enums below here! See UShooterReplicationGraph::IsSpatialized
 
-	Spatialize_Static,				// Routes to GridNode: these actors don't move and don't need to be updated every frame.
+	Spatialize_Static,				// Routes to CoarseGridNode (GridNode without one): these actors don't move and don't need to be updated every frame.
 	Spatialize_Dynamic,				// Routes to GridNode: these actors mode frequently and are updated once per frame.
-	Spatialize_Dormancy,			// Routes to GridNode: While dormant we treat as static. When flushed/not dormant dynamic. Note this is for things that "move while not dormant".
+	Spatialize_Dormancy,			// Routes to CoarseGridNode (GridNode without one): While dormant we treat as static. When flushed/not dormant dynamic. Note this is for things that "move while not dormant".
+	Spatialize_PVS,					// Routes to PVSNode: culled against the map's baked potential visibility table instead of the grid. Moves every frame.
+	Spatialize_Projectile,			// Routes to ProjectileNode: fast movers, gathered only for connections near their predicted path.
 };
 
 /** ShooterGame Replication Graph implementation. See additional notes in ShooterReplicationGraph.cpp! */
@@ -38,6 +46,8 @@ public:
 	UShooterReplicationGraph();
 
 	virtual void ResetGameWorldState() override;
+	virtual void SetRepDriverWorld(UWorld* InWorld) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
 
 	virtual void InitGlobalActorClassSettings() override;
 	virtual void InitGlobalGraphNodes() override;
@@ -57,11 +67,30 @@ public:
 	UPROPERTY()
 	UReplicationGraphNode_GridSpatialization2D* GridNode;
 
+	/** Grid with bigger cells for static and dormant actors, null unless ShooterRepGraph.CoarseGrid was set when the graph was created */
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* CoarseGridNode;
+
 	UPROPERTY()
 	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
 
+	UPROPERTY()
+	UShooterReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode;
+
+	UPROPERTY()
+	UShooterReplicationGraphNode_PVS* PVSNode;
+
+	UPROPERTY()
+	UShooterReplicationGraphNode_Projectiles* ProjectileNode;
+
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
+	/** counters filled in by the graph and its nodes while ShooterRepGraph.Telemetry is set */
+	FShooterRepGraphTelemetry Telemetry;
+
+	/** lowers replication rates while the server is over its frame budget, see ShooterRepGraph.Governor */
+	FShooterRepGraphGovernor Governor;
+
 	void OnCharacterEquipWeapon(AShooterCharacter* Character, AShooterWeapon* NewWeapon);
 	void OnCharacterUnEquipWeapon(AShooterCharacter* Character, AShooterWeapon* OldWeapon);
 
@@ -73,11 +102,72 @@ public:
 
 private:
 
+	/** Always relevant streaming level actors: a dormant actor may need replicating again, let the connections re-check its level */
+	void OnAlwaysRelevantStreamingActorDormancyFlush(FActorRepListType Actor, FGlobalActorReplicationInfo& GlobalInfo);
+	void OnAlwaysRelevantStreamingActorDormancyChange(FActorRepListType Actor, FGlobalActorReplicationInfo& GlobalInfo, ENetDormancy NewValue, ENetDormancy OldValue);
+	void NotifyAlwaysRelevantStreamingLevelChanged(FName LevelName);
+
+	/** Actor channels opened while ShooterRepGraph.Telemetry is set are UShooterActorChannels, which count bytes per class. Takes the engine's back once it is cleared. */
+	void UpdateActorChannelClass();
+
+	/** Pushes the settings of Governor's current level to the frequency buckets, PlayerStateNode and the replication periods of spatialized classes (and their actors) */
+	void ApplyGovernorLevel();
+
+	/** Sizes and positions GridNode and CoarseGridNode from the level bounds of InWorld, see ShooterRepGraph.AutoGrid */
+	void ConfigureGridForWorld(UWorld* InWorld);
+
+	/** Grid static and dormant actors go to */
+	UReplicationGraphNode_GridSpatialization2D* GetStaticGridNode() const { return CoarseGridNode ? CoarseGridNode : GridNode; }
+
 	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
 
 	bool IsSpatialized(EClassRepNodeMapping Mapping) const { return Mapping >= EClassRepNodeMapping::Spatialize_Static; }
 
 	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
+
+	/** Replication periods set up by InitGlobalActorClassSettings, what the governor scales */
+	TMap<FObjectKey, uint32> BaseClassReplicationPeriods;
+
+	/** Scale currently applied on top of BaseClassReplicationPeriods */
+	uint32 AppliedPeriodScale = 1;
+
+	/** PlayerStateNode->TargetActorsPerFrame before the governor touched it */
+	int32 BasePlayerStatesPerFrame = 2;
+};
+
+/** Grid spatialization node that keeps track of how long gathering and preparing takes and periodically logs it, so grid configurations can be compared. */
+UCLASS()
+class UShooterReplicationGraphNode_GridSpatialization2D : public UReplicationGraphNode_GridSpatialization2D
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void PrepareForReplication() override;
+
+	/** Logs the timings gathered so far and starts over. Also used when the grid configuration changes so the numbers are not mixed. */
+	void FlushTimings(const TCHAR* Reason);
+
+	/** Flushes the timings before CellSize/SpatialBias are changed, the next log is labeled as after the change */
+	void SetGrid(float InCellSize, const FVector2D& InSpatialBias);
+
+	/** Name in the timing logs and telemetry */
+	FName GridName = TEXT("Grid");
+
+private:
+
+	bool bGridChanged = false;
+
+	uint64 GatherCycles = 0;
+	uint64 MaxGatherCycles = 0;
+	int32 NumGathers = 0;
+
+	uint64 PrepareCycles = 0;
+	int32 NumPrepares = 0;
+
+	double LastLogTime = 0.0;
 };
 
 UCLASS()
@@ -98,6 +188,9 @@ public:
 	void OnClientLevelVisibilityAdd(FName LevelName, UWorld* StreamingWorld);
 	void OnClientLevelVisibilityRemove(FName LevelName);
 
+	/** an always relevant actor of LevelName was added, flushed or woken up */
+	void OnStreamingLevelActorsChanged(FName LevelName);
+
 	void ResetGameWorldState();
 
 #if WITH_GAMEPLAY_DEBUGGER
@@ -106,10 +199,27 @@ public:
 
 private:
 
+	/** telemetry: how long relevant pawns have gone without replicating to this connection */
+	void RecordStarvation(const FConnectionGatherActorListParameters& Params) const;
+
+	/** Rebuilds ReplicationActorList and PlayerStateList from RelevantActors and applies the per connection settings of newly relevant actors */
+	void RebuildReplicationActorList(const FConnectionGatherActorListParameters& Params);
+
+	/** Streaming levels the client has loaded and visible */
+	TArray<FName, TInlineAllocator<64> > VisibleStreamingLevels;
+
+	/** Subset of VisibleStreamingLevels with at least one always relevant actor that isn't dormant on this connection. Only re-checked every few frames and on dormancy events. */
 	TArray<FName, TInlineAllocator<64> > AlwaysRelevantStreamingLevelsNeedingReplication;
 
+	/** Persistent, only rebuilt when RelevantActors changes */
 	FActorRepListRefView ReplicationActorList;
 
+	/** The viewers' own PlayerStates, split out of ReplicationActorList so they can be gathered every other frame */
+	FActorRepListRefView PlayerStateList;
+
+	/** What ReplicationActorList was built from: viewers, view targets, player states, pawns, weapons. Weak so a new actor reusing a destroyed one's memory still counts as a change. */
+	TArray<TWeakObjectPtr<AActor>, TInlineAllocator<16> > RelevantActors;
+
 	UPROPERTY()
 	AActor* LastPawn = nullptr;
 
@@ -128,8 +238,9 @@ class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplica
 
 	UShooterReplicationGraphNode_PlayerStateFrequencyLimiter();
 
-	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
-	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override;
+	virtual void NotifyResetAllNetworkActors() override;
 
 	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
 
@@ -141,7 +252,166 @@ class UShooterReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplica
 	int32 TargetActorsPerFrame = 2;
 
 private:
-	
+
+	/** Rebuilds the buckets from scratch, keeping them compact. Only done after a player state leaves or TargetActorsPerFrame changes. */
+	void RebuildBuckets();
+
+	/** Persistent buckets of player states. Every bucket except the last one is full (TargetActorsPerFrame actors). */
 	TArray<FActorRepListRefView> ReplicationActorLists;
 	FActorRepListRefView ForceNetUpdateReplicationActorList;
-};
\ No newline at end of file
+
+	/** TargetActorsPerFrame the buckets were built with */
+	int32 BucketSize = 0;
+
+	/** A player state left, so a bucket may have a hole in it. The lists are compacted on the next PrepareForReplication. */
+	bool bNeedsDefrag = false;
+
+	/** This frame's bucket without the player states that can't be gathered (pending kill, torn off). Only built when the bucket has any. */
+	FActorRepListRefView ValidActorList;
+
+	/** This frame's bucket was checked by the first gather since PrepareForReplication */
+	bool bCheckedBucket = false;
+
+	/** This frame's bucket had player states that can't be gathered, ValidActorList is handed out instead */
+	bool bUseValidActorList = false;
+};
+/**
+ * Holds the actors routed as Spatialize_PVS (pawns) and only returns those that can possibly be seen from the viewer's cell of the map's
+ * baked UShooterPVSData table. Lists are built lazily once per frame per viewer cell and shared by every connection in that cell.
+ * Without a table (or outside of it) every actor is returned and distance culling is all that applies.
+ */
+UCLASS()
+class UShooterReplicationGraphNode_PVS : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterReplicationGraphNode_PVS();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void PrepareForReplication() override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+	void SetPVSData(UShooterPVSData* InPVSData);
+
+	/** every actor routed to this node, regardless of visibility */
+	const FActorRepListRefView& GetAllActors() const { return AllActors; }
+
+	/** table for the current map, may be null */
+	UPROPERTY()
+	UShooterPVSData* PVSData = nullptr;
+
+private:
+
+	/** actors visible from one viewer cell */
+	struct FCellList
+	{
+		FActorRepListRefView List;
+		uint32 BuiltFrame = 0;
+	};
+
+	/** every actor routed to this node */
+	FActorRepListRefView AllActors;
+
+	/** cell an actor was in at PrepareForReplication, INDEX_NONE outside the table */
+	struct FActorCell
+	{
+		/** null once the actor was removed, until the next PrepareForReplication drops the entry */
+		FActorRepListType Actor;
+		int32 Cell;
+	};
+
+	/** every actor of AllActors at the last PrepareForReplication */
+	TArray<FActorCell> ActorCells;
+
+	/** actors added since the last PrepareForReplication (or the PVS data changed), their cell isn't known yet */
+	TArray<FActorRepListType> NewActors;
+
+	/** viewer cell -> visible actors. Only valid when BuiltFrame == CurrentFrame */
+	TMap<int32, FCellList> CellLists;
+
+	uint32 CurrentFrame = 0;
+};
+
+/**
+ * Holds the actors routed as Spatialize_Projectile. Once per frame every projectile's path for the rest of its life (capped by
+ * ShooterRepGraph.Projectile.MaxLookahead) is swept by its cull distance, and a connection only gathers the projectiles whose swept
+ * capsule contains one of its viewers. Projectiles are not distance culled by the driver, this node is their only relevancy test.
+ */
+UCLASS()
+class UShooterReplicationGraphNode_Projectiles : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterReplicationGraphNode_Projectiles();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void PrepareForReplication() override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+private:
+
+	/** swept relevancy volume of a projectile, built in PrepareForReplication */
+	struct FProjectileSweep
+	{
+		/** null once the projectile was removed, until the next PrepareForReplication drops the sweep */
+		FActorRepListType Actor;
+		FVector Start;
+		FVector End;
+		float RadiusSquared;
+	};
+
+	/** every projectile routed to this node */
+	FActorRepListRefView AllProjectiles;
+
+	/** every projectile of AllProjectiles at the last PrepareForReplication */
+	TArray<FProjectileSweep> Sweeps;
+
+	/** projectiles added since the last PrepareForReplication, not swept yet */
+	TArray<FActorRepListType> NewProjectiles;
+
+	/** per connection results of this frame. Reused frame to frame, NumConnectionListsUsed are valid. */
+	TArray<FActorRepListRefView> ConnectionLists;
+	int32 NumConnectionListsUsed = 0;
+};
+
+/**
+ * Connection specific node that doesn't gather anything itself. Instead it adjusts the connection's replication period of every pawn by where it is
+ * relative to the viewer's view direction: pawns on screen, the connection's recent attacker and (for spectators of bots) the bot's enemy replicate
+ * at their normal rate, pawns off to the side or behind the viewer less often. Bandwidth that would go to actors behind the player goes to the ones in front.
+ */
+UCLASS()
+class UShooterReplicationGraphNode_ViewPriority_ForConnection : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override { }
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+
+private:
+
+	/** the connection's periods were changed and need restoring when the feature is turned off */
+	bool bAppliedPeriods = false;
+};
@@ -0,0 +1,143 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterReplicationGraphGovernor.h"
+
+int32 CVar_ShooterRepGraph_Governor = 1;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernor(TEXT("ShooterRepGraph.Governor"), CVar_ShooterRepGraph_Governor, TEXT("Lower replication rates while the server can't hold its tick rate. 0 returns to the configured rates."), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_GovernorMaxLevel = 3;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorMaxLevel(TEXT("ShooterRepGraph.Governor.MaxLevel"), CVar_ShooterRepGraph_GovernorMaxLevel, TEXT("Number of steps between the configured rates and the lowest (Max*) ones"), ECVF_Default );
+
+float CVar_ShooterRepGraph_GovernorHighWater = 0.9f;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorHighWater(TEXT("ShooterRepGraph.Governor.HighWater"), CVar_ShooterRepGraph_GovernorHighWater, TEXT("Step up when the average frame time is over this fraction of the frame budget"), ECVF_Default );
+
+float CVar_ShooterRepGraph_GovernorLowWater = 0.6f;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorLowWater(TEXT("ShooterRepGraph.Governor.LowWater"), CVar_ShooterRepGraph_GovernorLowWater, TEXT("Step down when the average frame and replication times are under this fraction of their budgets"), ECVF_Default );
+
+float CVar_ShooterRepGraph_GovernorReplicationBudget = 0.3f;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorReplicationBudget(TEXT("ShooterRepGraph.Governor.ReplicationBudget"), CVar_ShooterRepGraph_GovernorReplicationBudget, TEXT("Fraction of the frame budget replication may take before stepping up"), ECVF_Default );
+
+float CVar_ShooterRepGraph_GovernorSpikeFactor = 2.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorSpikeFactor(TEXT("ShooterRepGraph.Governor.SpikeFactor"), CVar_ShooterRepGraph_GovernorSpikeFactor, TEXT("A single frame this many times over budget steps up without waiting for EscalateTime"), ECVF_Default );
+
+float CVar_ShooterRepGraph_GovernorEscalateTime = 0.5f;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorEscalateTime(TEXT("ShooterRepGraph.Governor.EscalateTime"), CVar_ShooterRepGraph_GovernorEscalateTime, TEXT("Seconds over budget before stepping up, also the minimum time between two steps up"), ECVF_Default );
+
+float CVar_ShooterRepGraph_GovernorRecoverTime = 5.f;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorRecoverTime(TEXT("ShooterRepGraph.Governor.RecoverTime"), CVar_ShooterRepGraph_GovernorRecoverTime, TEXT("Seconds under budget before stepping down"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_GovernorMaxFrequencyBuckets = 6;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorMaxFrequencyBuckets(TEXT("ShooterRepGraph.Governor.MaxFrequencyBuckets"), CVar_ShooterRepGraph_GovernorMaxFrequencyBuckets, TEXT("Dynamic actor frequency buckets at MaxLevel (ShooterRepGraph.DynamicActorFrequencyBuckets at level 0)"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_GovernorMinPlayerStatesPerFrame = 1;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorMinPlayerStatesPerFrame(TEXT("ShooterRepGraph.Governor.MinPlayerStatesPerFrame"), CVar_ShooterRepGraph_GovernorMinPlayerStatesPerFrame, TEXT("Player states replicated per frame at MaxLevel"), ECVF_Default );
+
+int32 CVar_ShooterRepGraph_GovernorMaxPeriodScale = 3;
+static FAutoConsoleVariableRef CVarShooterRepGraphGovernorMaxPeriodScale(TEXT("ShooterRepGraph.Governor.MaxPeriodScale"), CVar_ShooterRepGraph_GovernorMaxPeriodScale, TEXT("Replication period multiplier of spatialized classes at MaxLevel"), ECVF_Default );
+
+/** weight of the current frame in the moving averages */
+static const float GovernorAverageWeight = 0.1f;
+
+bool FShooterRepGraphGovernor::IsEnabled()
+{
+	return CVar_ShooterRepGraph_Governor != 0;
+}
+
+bool FShooterRepGraphGovernor::Update(float FrameSeconds, float ReplicationSeconds, float TargetFrameSeconds)
+{
+	if (!IsEnabled() || TargetFrameSeconds <= 0.f)
+	{
+		return Reset();
+	}
+
+	// Hitches (loading, GC) would poison the averages for seconds, the spike check below deals with them
+	const float ClampedFrameSeconds = FMath::Min(FrameSeconds, TargetFrameSeconds * 10.f);
+	AvgFrameSeconds = AvgFrameSeconds > 0.f ? FMath::Lerp(AvgFrameSeconds, ClampedFrameSeconds, GovernorAverageWeight) : ClampedFrameSeconds;
+	AvgReplicationSeconds = AvgReplicationSeconds > 0.f ? FMath::Lerp(AvgReplicationSeconds, ReplicationSeconds, GovernorAverageWeight) : ReplicationSeconds;
+
+	const float ReplicationBudget = TargetFrameSeconds * CVar_ShooterRepGraph_GovernorReplicationBudget;
+	const bool bOverBudget = AvgFrameSeconds > TargetFrameSeconds * CVar_ShooterRepGraph_GovernorHighWater || AvgReplicationSeconds > ReplicationBudget;
+	const bool bUnderBudget = AvgFrameSeconds < TargetFrameSeconds * CVar_ShooterRepGraph_GovernorLowWater && AvgReplicationSeconds < ReplicationBudget * CVar_ShooterRepGraph_GovernorLowWater;
+
+	TimeOverBudget = bOverBudget ? TimeOverBudget + FrameSeconds : 0.f;
+	TimeUnderBudget = bUnderBudget ? TimeUnderBudget + FrameSeconds : 0.f;
+
+	const auto Describe = [&](const TCHAR* What)
+	{
+		return FString::Printf(TEXT("%s: frame %.2fms (avg %.2fms), replication avg %.2fms, budget %.2fms/%.2fms"), What,
+			FrameSeconds * 1000.f, AvgFrameSeconds * 1000.f, AvgReplicationSeconds * 1000.f, TargetFrameSeconds * 1000.f, ReplicationBudget * 1000.f);
+	};
+
+	if (FrameSeconds > TargetFrameSeconds * CVar_ShooterRepGraph_GovernorSpikeFactor && TimeSinceLevelChange >= CVar_ShooterRepGraph_GovernorEscalateTime)
+	{
+		return SetLevel(Level + 1, Describe(TEXT("spike")));
+	}
+
+	TimeSinceLevelChange += FrameSeconds;
+
+	if (TimeOverBudget >= CVar_ShooterRepGraph_GovernorEscalateTime && TimeSinceLevelChange >= CVar_ShooterRepGraph_GovernorEscalateTime)
+	{
+		return SetLevel(Level + 1, Describe(TEXT("over budget")));
+	}
+
+	if (TimeUnderBudget >= CVar_ShooterRepGraph_GovernorRecoverTime)
+	{
+		return SetLevel(Level - 1, Describe(TEXT("under budget")));
+	}
+
+	// Bounds changed at runtime
+	if (Level > FMath::Max(CVar_ShooterRepGraph_GovernorMaxLevel, 0))
+	{
+		return SetLevel(CVar_ShooterRepGraph_GovernorMaxLevel, TEXT("MaxLevel lowered"));
+	}
+
+	return false;
+}
+
+bool FShooterRepGraphGovernor::Reset()
+{
+	AvgFrameSeconds = 0.f;
+	AvgReplicationSeconds = 0.f;
+	return SetLevel(0, TEXT("reset"));
+}
+
+bool FShooterRepGraphGovernor::SetLevel(int32 NewLevel, const FString& Reason)
+{
+	NewLevel = FMath::Clamp(NewLevel, 0, FMath::Max(CVar_ShooterRepGraph_GovernorMaxLevel, 0));
+
+	TimeOverBudget = 0.f;
+	TimeUnderBudget = 0.f;
+
+	if (NewLevel == Level)
+	{
+		return false;
+	}
+
+	Level = NewLevel;
+	TimeSinceLevelChange = 0.f;
+	LastReason = Reason;
+	return true;
+}
+
+float FShooterRepGraphGovernor::GetAlpha() const
+{
+	return CVar_ShooterRepGraph_GovernorMaxLevel > 0 ? FMath::Clamp((float)Level / CVar_ShooterRepGraph_GovernorMaxLevel, 0.f, 1.f) : 0.f;
+}
+
+int32 FShooterRepGraphGovernor::GetFrequencyBuckets(int32 BaseBuckets) const
+{
+	BaseBuckets = FMath::Max(BaseBuckets, 1);
+	return FMath::RoundToInt(FMath::Lerp((float)BaseBuckets, (float)FMath::Max(CVar_ShooterRepGraph_GovernorMaxFrequencyBuckets, BaseBuckets), GetAlpha()));
+}
+
+int32 FShooterRepGraphGovernor::GetPlayerStatesPerFrame(int32 BaseActorsPerFrame) const
+{
+	BaseActorsPerFrame = FMath::Max(BaseActorsPerFrame, 1);
+	return FMath::RoundToInt(FMath::Lerp((float)BaseActorsPerFrame, (float)FMath::Clamp(CVar_ShooterRepGraph_GovernorMinPlayerStatesPerFrame, 1, BaseActorsPerFrame), GetAlpha()));
+}
+
+uint32 FShooterRepGraphGovernor::GetPeriodScale() const
+{
+	return (uint32)FMath::RoundToInt(FMath::Lerp(1.f, (float)FMath::Max(CVar_ShooterRepGraph_GovernorMaxPeriodScale, 1), GetAlpha()));
+}
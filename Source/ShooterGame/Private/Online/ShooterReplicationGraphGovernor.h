@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Load level for UShooterReplicationGraph, driven by server frame time and replication time (ShooterRepGraph.Governor.*).
+ *
+ * Level 0 is the configured replication rate, every level above it replicates less: more dynamic actor frequency buckets,
+ * fewer player states per frame and longer replication periods for spatialized classes, up to ShooterRepGraph.Governor.MaxLevel.
+ * Going up is quick (and immediate on a spike) so a load spike does not keep blowing the frame budget, coming back down is slow.
+ * The graph applies the settings of the current level whenever Update reports a change, every change is logged.
+ */
+class FShooterRepGraphGovernor
+{
+public:
+
+	static bool IsEnabled();
+
+	/**
+	 * Feeds one frame's timings in.
+	 *
+	 * @param	FrameSeconds		Server frame time (DeltaSeconds of the tick)
+	 * @param	ReplicationSeconds	Time ServerReplicateActors took
+	 * @param	TargetFrameSeconds	Frame budget, 1 / NetServerMaxTickRate
+	 * @return	true if the level changed and the graph should apply the new settings
+	 */
+	bool Update(float FrameSeconds, float ReplicationSeconds, float TargetFrameSeconds);
+
+	/** back to level 0, e.g. when disabled */
+	bool Reset();
+
+	int32 GetLevel() const { return Level; }
+
+	/** number of buckets for dynamic actors at the current level, BaseBuckets at level 0 */
+	int32 GetFrequencyBuckets(int32 BaseBuckets) const;
+
+	/** player states returned per frame by the player state limiter, BaseActorsPerFrame at level 0 */
+	int32 GetPlayerStatesPerFrame(int32 BaseActorsPerFrame) const;
+
+	/** multiplier for the replication period of spatialized classes, 1 at level 0 */
+	uint32 GetPeriodScale() const;
+
+	/** why the level last changed, for the log */
+	const FString& GetLastReason() const { return LastReason; }
+
+private:
+
+	bool SetLevel(int32 NewLevel, const FString& Reason);
+
+	/** level relative to MaxLevel, 0..1 */
+	float GetAlpha() const;
+
+	int32 Level = 0;
+
+	/** exponential moving averages, seconds */
+	float AvgFrameSeconds = 0.f;
+	float AvgReplicationSeconds = 0.f;
+
+	/** how long the averages have been over the high / under the low water mark */
+	float TimeOverBudget = 0.f;
+	float TimeUnderBudget = 0.f;
+
+	/** steps up are at least EscalateTime apart */
+	float TimeSinceLevelChange = 0.f;
+
+	FString LastReason;
+};
@@ -0,0 +1,170 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "ShooterReplicationGraphTelemetry.h"
+#include "ReplicationGraph.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(ShooterRepGraph, true);
+
+int32 CVar_ShooterRepGraph_Telemetry = 0;
+static FAutoConsoleVariableRef CVarShooterRepGraphTelemetry(TEXT("ShooterRepGraph.Telemetry"), CVar_ShooterRepGraph_Telemetry, TEXT("Collect per node/connection replication graph counters, see ShooterRepGraph.Telemetry.Dump"), ECVF_Default );
+
+bool FShooterRepGraphTelemetry::IsEnabled()
+{
+	return CVar_ShooterRepGraph_Telemetry != 0;
+}
+
+int32 FShooterRepGraphTelemetry::CountActors(const FGatheredReplicationActorLists& Lists)
+{
+	int32 NumActors = 0;
+	for (int32 ListType = 0; ListType < (int32)EActorRepListTypeFlags::Max; ++ListType)
+	{
+		for (const FActorRepListRefView& List : Lists.GetLists((EActorRepListTypeFlags)ListType))
+		{
+			NumActors += List.Num();
+		}
+	}
+	return NumActors;
+}
+
+void FShooterRepGraphTelemetry::RecordGather(FName NodeName, uint32 Cycles, int32 NumActors)
+{
+	FNodeCounters* Counters = Nodes.Find(NodeName);
+	if (Counters == nullptr)
+	{
+		Counters = &Nodes.Add(NodeName);
+		Counters->CsvGatherTimeStat = *FString::Printf(TEXT("GatherUs_%s"), *NodeName.ToString());
+		Counters->CsvActorsStat = *FString::Printf(TEXT("Actors_%s"), *NodeName.ToString());
+	}
+
+	Counters->GatherCycles += Cycles;
+	Counters->MaxGatherCycles = FMath::Max<uint64>(Counters->MaxGatherCycles, Cycles);
+	Counters->ActorsGathered += NumActors;
+	Counters->NumGathers++;
+
+	Counters->FrameGatherCycles += Cycles;
+	Counters->FrameActorsGathered += NumActors;
+}
+
+void FShooterRepGraphTelemetry::RecordStarvation(const UNetReplicationGraphConnection& Connection, uint32 FramesSinceReplicated)
+{
+	FConnectionCounters& Counters = Connections.FindOrAdd(Connection.ConnectionId);
+	Counters.StarvationFrames += FramesSinceReplicated;
+	Counters.MaxStarvationFrames = FMath::Max(Counters.MaxStarvationFrames, FramesSinceReplicated);
+	Counters.NumStarvationSamples++;
+}
+
+void FShooterRepGraphTelemetry::SetClassTracking(UClass* ActorClass, FName StatName)
+{
+	TrackedClasses.Emplace(ActorClass, StatName);
+	ClassStatNames.Reset();
+}
+
+FName FShooterRepGraphTelemetry::GetClassStatName(UClass* ActorClass)
+{
+	if (const FName* StatName = ClassStatNames.Find(ActorClass))
+	{
+		return *StatName;
+	}
+
+	FName StatName = TEXT("Other");
+	for (const TPair<UClass*, FName>& TrackedClass : TrackedClasses)
+	{
+		if (ActorClass->IsChildOf(TrackedClass.Key))
+		{
+			StatName = TrackedClass.Value;
+			break;
+		}
+	}
+
+	ClassStatNames.Add(ActorClass, StatName);
+	return StatName;
+}
+
+void FShooterRepGraphTelemetry::RecordBunch(UClass* ActorClass, int64 NumBits)
+{
+	FClassCounters& Counters = Classes.FindOrAdd(GetClassStatName(ActorClass));
+	Counters.Bits += NumBits;
+	Counters.NumBunches++;
+}
+
+void FShooterRepGraphTelemetry::EndFrame(const TArray<UNetReplicationGraphConnection*>& GraphConnections)
+{
+	NumFrames++;
+
+	for (const UNetReplicationGraphConnection* GraphConnection : GraphConnections)
+	{
+		if (GraphConnection && GraphConnection->NetConnection)
+		{
+			FConnectionCounters& Counters = Connections.FindOrAdd(GraphConnection->ConnectionId);
+			if (Counters.Name.IsEmpty())
+			{
+				Counters.Name = GraphConnection->NetConnection->LowLevelGetRemoteAddress(true);
+			}
+
+			Counters.OutBytesPerSecondSum += GraphConnection->NetConnection->OutBytesPerSecond;
+			Counters.NumBandwidthSamples++;
+		}
+	}
+
+	for (TPair<FName, FNodeCounters>& Node : Nodes)
+	{
+#if CSV_PROFILER
+		FCsvProfiler::RecordCustomStat(Node.Value.CsvGatherTimeStat, CSV_CATEGORY_INDEX(ShooterRepGraph), (float)(FPlatformTime::ToMilliseconds64(Node.Value.FrameGatherCycles) * 1000.0), ECsvCustomStatOp::Set);
+		FCsvProfiler::RecordCustomStat(Node.Value.CsvActorsStat, CSV_CATEGORY_INDEX(ShooterRepGraph), (float)Node.Value.FrameActorsGathered, ECsvCustomStatOp::Set);
+#endif
+		Node.Value.FrameGatherCycles = 0;
+		Node.Value.FrameActorsGathered = 0;
+	}
+}
+
+bool FShooterRepGraphTelemetry::WriteCSV(const FString& Filename) const
+{
+	const double MicrosecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000000.0;
+	const float Frames = (float)FMath::Max(NumFrames, 1);
+
+	TArray<FString> Lines;
+	Lines.Add(TEXT("Type,Name,Frames,Gathers,AvgGatherUs,MaxGatherUs,GatherUsPerFrame,ActorsPerFrame,StarvationSamples,AvgStarvationFrames,MaxStarvationFrames,AvgOutBytesPerSecond,Bunches,Bytes,BytesPerFrame,AvgBytesPerBunch"));
+
+	for (const TPair<FName, FNodeCounters>& Node : Nodes)
+	{
+		const FNodeCounters& Counters = Node.Value;
+		Lines.Add(FString::Printf(TEXT("Node,%s,%d,%d,%.2f,%.2f,%.2f,%.2f,,,,,,,,"), *Node.Key.ToString(), NumFrames, Counters.NumGathers,
+			Counters.NumGathers > 0 ? Counters.GatherCycles * MicrosecondsPerCycle / Counters.NumGathers : 0.0,
+			Counters.MaxGatherCycles * MicrosecondsPerCycle,
+			Counters.GatherCycles * MicrosecondsPerCycle / Frames,
+			Counters.ActorsGathered / Frames));
+	}
+
+	for (const TPair<int32, FConnectionCounters>& Connection : Connections)
+	{
+		const FConnectionCounters& Counters = Connection.Value;
+		Lines.Add(FString::Printf(TEXT("Connection,%d %s,%d,,,,,,%d,%.2f,%u,%.0f,,,,"), Connection.Key, *Counters.Name, NumFrames,
+			Counters.NumStarvationSamples,
+			Counters.NumStarvationSamples > 0 ? (float)Counters.StarvationFrames / Counters.NumStarvationSamples : 0.f,
+			Counters.MaxStarvationFrames,
+			Counters.NumBandwidthSamples > 0 ? (float)Counters.OutBytesPerSecondSum / Counters.NumBandwidthSamples : 0.f));
+	}
+
+	for (const TPair<FName, FClassCounters>& Class : Classes)
+	{
+		const FClassCounters& Counters = Class.Value;
+		const double Bytes = Counters.Bits / 8.0;
+		Lines.Add(FString::Printf(TEXT("Class,%s,%d,,,,,,,,,,%d,%.0f,%.2f,%.2f"), *Class.Key.ToString(), NumFrames,
+			Counters.NumBunches,
+			Bytes,
+			Bytes / Frames,
+			Counters.NumBunches > 0 ? Bytes / Counters.NumBunches : 0.0));
+	}
+
+	return FFileHelper::SaveStringArrayToFile(Lines, *Filename);
+}
+
+void FShooterRepGraphTelemetry::Reset()
+{
+	Nodes.Reset();
+	Connections.Reset();
+	Classes.Reset();
+	NumFrames = 0;
+}
@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UNetReplicationGraphConnection;
+struct FGatheredReplicationActorLists;
+
+/**
+ * Structured counters for UShooterReplicationGraph, collected while ShooterRepGraph.Telemetry is set:
+ *  - gather time and actors gathered per node class
+ *  - starvation (frames since last replicated) of relevant pawns and bandwidth per connection
+ *  - bytes sent on actor channels per actor class, in the buckets set up with SetClassTracking (the engine's FReplicationGraphCSVTracker only has per frame values)
+ *
+ * Per frame values go to the CSV profiler (ShooterRepGraph category), totals are written with "ShooterRepGraph.Telemetry.Dump".
+ */
+class FShooterRepGraphTelemetry
+{
+public:
+
+	static bool IsEnabled();
+
+	/** actors in all of Lists, nodes that add to Params directly (grid) count before and after */
+	static int32 CountActors(const FGatheredReplicationActorLists& Lists);
+
+	/** Times a node's GatherActorListsForConnection. Set NumActors to what the node handed out. */
+	struct FScopedGather
+	{
+		FScopedGather(FShooterRepGraphTelemetry& InTelemetry, FName InNodeName)
+			: Telemetry(InTelemetry)
+			, NodeName(InNodeName)
+			, StartCycles(IsEnabled() ? FPlatformTime::Cycles() : 0)
+		{
+		}
+
+		~FScopedGather()
+		{
+			if (StartCycles != 0)
+			{
+				Telemetry.RecordGather(NodeName, FPlatformTime::Cycles() - StartCycles, NumActors);
+			}
+		}
+
+		int32 NumActors = 0;
+
+	private:
+		FShooterRepGraphTelemetry& Telemetry;
+		FName NodeName;
+		uint32 StartCycles;
+	};
+
+	void RecordGather(FName NodeName, uint32 Cycles, int32 NumActors);
+
+	/** an actor with an open channel to Connection has not been replicated for FramesSinceReplicated frames */
+	void RecordStarvation(const UNetReplicationGraphConnection& Connection, uint32 FramesSinceReplicated);
+
+	/** bytes sent for ActorClass and its subclasses are counted as StatName, the rest as "Other" */
+	void SetClassTracking(UClass* ActorClass, FName StatName);
+
+	/** a bunch of NumBits went out on the actor channel of an actor of ActorClass */
+	void RecordBunch(UClass* ActorClass, int64 NumBits);
+
+	/** called once per ServerReplicateActors: samples bandwidth and pushes the frame's values to the CSV profiler */
+	void EndFrame(const TArray<UNetReplicationGraphConnection*>& GraphConnections);
+
+	bool WriteCSV(const FString& Filename) const;
+
+	void Reset();
+
+private:
+
+	struct FNodeCounters
+	{
+		uint64 GatherCycles = 0;
+		uint64 MaxGatherCycles = 0;
+		int64 ActorsGathered = 0;
+		int32 NumGathers = 0;
+
+		/** current frame, pushed to the CSV profiler in EndFrame */
+		uint64 FrameGatherCycles = 0;
+		int32 FrameActorsGathered = 0;
+
+		FName CsvGatherTimeStat;
+		FName CsvActorsStat;
+	};
+
+	struct FConnectionCounters
+	{
+		FString Name;
+		int64 StarvationFrames = 0;
+		uint32 MaxStarvationFrames = 0;
+		int32 NumStarvationSamples = 0;
+		int64 OutBytesPerSecondSum = 0;
+		int32 NumBandwidthSamples = 0;
+	};
+
+	struct FClassCounters
+	{
+		int64 Bits = 0;
+		int32 NumBunches = 0;
+	};
+
+	/** stat name of ActorClass from TrackedClasses, cached per class */
+	FName GetClassStatName(UClass* ActorClass);
+
+	TMap<FName, FNodeCounters> Nodes;
+	TMap<int32, FConnectionCounters> Connections;
+	TMap<FName, FClassCounters> Classes;
+	TArray<TPair<UClass*, FName>> TrackedClasses;
+	TMap<UClass*, FName> ClassStatNames;
+	int32 NumFrames = 0;
+};
@@ -4,6 +4,10 @@
 #include "Pickups/ShooterPickup.h"
 #include "Particles/ParticleSystemComponent.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickups Dormant"), STAT_ShooterPickupsDormant, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickups Awake"), STAT_ShooterPickupsAwake, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Dormancy Flushes"), STAT_ShooterPickupDormancyFlushes, STATGROUP_Game);
+
 AShooterPickup::AShooterPickup(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	UCapsuleComponent* CollisionComp = ObjectInitializer.CreateDefaultSubobject<UCapsuleComponent>(this, TEXT("CollisionComp"));
@@ -25,6 +29,9 @@ AShooterPickup::AShooterPickup(const FObjectInitializer& ObjectInitializer) : Su
 
 	SetRemoteRoleForBackwardsCompat(ROLE_SimulatedProxy);
 	bReplicates = true;
+
+	// state only changes when picked up or respawned, see FlushPickupDormancy
+	NetDormancy = DORM_DormantAll;
 }
 
 void AShooterPickup::BeginPlay()
@@ -41,6 +48,31 @@ void AShooterPickup::BeginPlay()
 	}
 }
 
+void AShooterPickup::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode)
+	{
+		GameMode->NumPickupsReplicated++;
+	}
+}
+
+void AShooterPickup::UpdateReplicationStats(const TArray<AShooterPickup*>& Pickups, int32 NumReplicated)
+{
+	int32 NumPickups = 0;
+	for (const AShooterPickup* Pickup : Pickups)
+	{
+		NumPickups += (Pickup && !Pickup->IsPendingKill()) ? 1 : 0;
+	}
+
+	// more than one driver (replay recording) replicates the same pickup more than once
+	const int32 NumAwake = FMath::Min(NumReplicated, NumPickups);
+	SET_DWORD_STAT(STAT_ShooterPickupsAwake, NumAwake);
+	SET_DWORD_STAT(STAT_ShooterPickupsDormant, NumPickups - NumAwake);
+}
+
 void AShooterPickup::NotifyActorBeginOverlap(class AActor* Other)
 {
 	Super::NotifyActorBeginOverlap(Other);
@@ -94,8 +126,19 @@ void AShooterPickup::RespawnPickup()
 	}
 }
 
+void AShooterPickup::FlushPickupDormancy()
+{
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		FlushNetDormancy();
+		INC_DWORD_STAT(STAT_ShooterPickupDormancyFlushes);
+	}
+}
+
 void AShooterPickup::OnPickedUp()
 {
+	FlushPickupDormancy();
+
 	if (RespawningFX)
 	{
 		PickupPSC->SetTemplate(RespawningFX);
@@ -116,6 +159,8 @@ void AShooterPickup::OnPickedUp()
 
 void AShooterPickup::OnRespawned()
 {
+	FlushPickupDormancy();
+
 	if (ActiveFX)
 	{
 		PickupPSC->SetTemplate(ActiveFX);
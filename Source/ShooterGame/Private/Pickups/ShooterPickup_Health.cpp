@@ -3,6 +3,7 @@
 #include "ShooterGame.h"
 #include "Pickups/ShooterPickup_Health.h"
 #include "OnlineSubsystemUtils.h"
+#include "Online/ShooterPushModel.h"
 
 AShooterPickup_Health::AShooterPickup_Health(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -19,6 +20,7 @@ void AShooterPickup_Health::GivePickupTo(class AShooterCharacter* Pawn)
 	if (Pawn)
 	{
 		Pawn->Health = FMath::Min(FMath::TruncToInt(Pawn->Health) + Health, Pawn->GetMaxHealth());
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, Health, Pawn);
 
 		// Fire event for collected health
 		const UWorld* World = GetWorld();
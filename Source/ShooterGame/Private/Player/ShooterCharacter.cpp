@@ -5,6 +5,9 @@
 #include "Weapons/ShooterDamageType.h"
 #include "UI/ShooterHUD.h"
 #include "Online/ShooterPlayerState.h"
+#include "Online/ShooterNetVisibilitySubsystem.h"
+#include "Online/ShooterLagCompensationSubsystem.h"
+#include "Online/ShooterPushModel.h"
 #include "Animation/AnimMontage.h"
 #include "Animation/AnimInstance.h"
 #include "Sound/SoundNodeLocalPlayer.h"
@@ -67,6 +70,8 @@ AShooterCharacter::AShooterCharacter(const FObjectInitializer& ObjectInitializer
 
 	BaseTurnRate = 45.f;
 	BaseLookUpRate = 45.f;
+
+	Inventory.Owner = this;
 }
 
 void AShooterCharacter::PostInitializeComponents()
@@ -76,9 +81,19 @@ void AShooterCharacter::PostInitializeComponents()
 	if (GetLocalRole() == ROLE_Authority)
 	{
 		Health = GetMaxHealth();
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, Health, this);
 
 		// Needs to happen after character is added to repgraph
 		GetWorldTimerManager().SetTimerForNextTick(this, &AShooterCharacter::SpawnDefaultInventory);
+
+		// remote clients' hits on us are checked against where we were when they fired
+		if (GetNetMode() == NM_DedicatedServer || GetNetMode() == NM_ListenServer)
+		{
+			if (UShooterLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UShooterLagCompensationSubsystem>())
+			{
+				LagCompensation->Register(this);
+			}
+		}
 	}
 
 	// set initial mesh visibility (3rd person view)
@@ -109,6 +124,11 @@ void AShooterCharacter::Destroyed()
 {
 	Super::Destroyed();
 	DestroyInventory();
+
+	if (UShooterLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UShooterLagCompensationSubsystem>())
+	{
+		LagCompensation->Unregister(this);
+	}
 }
 
 void AShooterCharacter::PawnClientRestart()
@@ -275,6 +295,7 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 	if (ActualDamage > 0.f)
 	{
 		Health -= ActualDamage;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, Health, this);
 		if (Health <= 0)
 		{
 			Die(ActualDamage, DamageEvent, EventInstigator, DamageCauser);
@@ -314,6 +335,7 @@ bool AShooterCharacter::Die(float KillingDamage, FDamageEvent const& DamageEvent
 	}
 
 	Health = FMath::Min(0.0f, Health);
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, Health, this);
 
 	// if this is an environmental death then refer to the previous killer so that they receive credit (knocked into lava pits, etc)
 	UDamageType const* const DamageType = DamageEvent.DamageTypeClass ? DamageEvent.DamageTypeClass->GetDefaultObject<UDamageType>() : GetDefault<UDamageType>();
@@ -527,8 +549,21 @@ void AShooterCharacter::ReplicateHit(float Damage, struct FDamageEvent const& Da
 	LastTakeHitInfo.SetDamageEvent(DamageEvent);
 	LastTakeHitInfo.bKilled = bKilled;
 	LastTakeHitInfo.EnsureReplication();
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, LastTakeHitInfo, this);
 
 	LastTakeHitTimeTimeout = TimeoutTime;
+	LastTakeHitTime = GetWorld()->GetTimeSeconds();
+}
+
+AShooterCharacter* AShooterCharacter::GetRecentAttacker(float MaxAge) const
+{
+	const UWorld* World = GetWorld();
+	if (World && World->GetTimeSeconds() - LastTakeHitTime <= MaxAge)
+	{
+		return LastTakeHitInfo.PawnInstigator.Get();
+	}
+
+	return nullptr;
 }
 
 void AShooterCharacter::OnRep_LastTakeHitInfo()
@@ -579,7 +614,7 @@ void AShooterCharacter::SpawnDefaultInventory()
 	// equip first weapon in inventory
 	if (Inventory.Num() > 0)
 	{
-		EquipWeapon(Inventory[0]);
+		EquipWeapon(Inventory.GetWeapon(0));
 	}
 }
 
@@ -593,7 +628,7 @@ void AShooterCharacter::DestroyInventory()
 	// remove all weapons from inventory and destroy them
 	for (int32 i = Inventory.Num() - 1; i >= 0; i--)
 	{
-		AShooterWeapon* Weapon = Inventory[i];
+		AShooterWeapon* Weapon = Inventory.GetWeapon(i);
 		if (Weapon)
 		{
 			RemoveWeapon(Weapon);
@@ -607,7 +642,8 @@ void AShooterCharacter::AddWeapon(AShooterWeapon* Weapon)
 	if (Weapon && GetLocalRole() == ROLE_Authority)
 	{
 		Weapon->OnEnterInventory(this);
-		Inventory.AddUnique(Weapon);
+		Inventory.Add(Weapon);
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, Inventory, this);
 	}
 }
 
@@ -616,7 +652,60 @@ void AShooterCharacter::RemoveWeapon(AShooterWeapon* Weapon)
 	if (Weapon && GetLocalRole() == ROLE_Authority)
 	{
 		Weapon->OnLeaveInventory();
-		Inventory.RemoveSingle(Weapon);
+		Inventory.Remove(Weapon);
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, Inventory, this);
+	}
+}
+
+int32 FShooterInventory::IndexOf(const AShooterWeapon* Weapon) const
+{
+	return Items.IndexOfByPredicate([Weapon](const FShooterInventoryEntry& Entry) { return Entry.Weapon == Weapon; });
+}
+
+void FShooterInventory::Add(AShooterWeapon* Weapon)
+{
+	if (IndexOf(Weapon) == INDEX_NONE)
+	{
+		FShooterInventoryEntry& Entry = Items.AddDefaulted_GetRef();
+		Entry.Weapon = Weapon;
+		MarkItemDirty(Entry);
+	}
+}
+
+void FShooterInventory::Remove(AShooterWeapon* Weapon)
+{
+	const int32 Index = IndexOf(Weapon);
+	if (Index != INDEX_NONE)
+	{
+		Items.RemoveAt(Index);
+		MarkArrayDirty();
+	}
+}
+
+void FShooterInventoryEntry::PostReplicatedAdd(const FShooterInventory& InArraySerializer)
+{
+	if (Weapon && InArraySerializer.Owner)
+	{
+		bEntered = true;
+		Weapon->OnEnterInventory(InArraySerializer.Owner);
+	}
+}
+
+void FShooterInventoryEntry::PostReplicatedChange(const FShooterInventory& InArraySerializer)
+{
+	// weapon wasn't resolved yet when the entry was added
+	if (!bEntered)
+	{
+		PostReplicatedAdd(InArraySerializer);
+	}
+}
+
+void FShooterInventoryEntry::PreReplicatedRemove(const FShooterInventory& InArraySerializer)
+{
+	// destroyed weapons clean up after themselves
+	if (bEntered && Weapon && !Weapon->IsPendingKill() && Weapon->GetPawnOwner() == InArraySerializer.Owner)
+	{
+		Weapon->OnLeaveInventory();
 	}
 }
 
@@ -624,9 +713,10 @@ AShooterWeapon* AShooterCharacter::FindWeapon(TSubclassOf<AShooterWeapon> Weapon
 {
 	for (int32 i = 0; i < Inventory.Num(); i++)
 	{
-		if (Inventory[i] && Inventory[i]->IsA(WeaponClass))
+		AShooterWeapon* Weapon = Inventory.GetWeapon(i);
+		if (Weapon && Weapon->IsA(WeaponClass))
 		{
-			return Inventory[i];
+			return Weapon;
 		}
 	}
 
@@ -683,6 +773,7 @@ void AShooterCharacter::SetCurrentWeapon(AShooterWeapon* NewWeapon, AShooterWeap
 	}
 
 	CurrentWeapon = NewWeapon;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, CurrentWeapon, this);
 
 	// equip new one
 	if (NewWeapon)
@@ -734,6 +825,7 @@ bool AShooterCharacter::CanReload() const
 void AShooterCharacter::SetTargeting(bool bNewTargeting)
 {
 	bIsTargeting = bNewTargeting;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, bIsTargeting, this);
 
 	if (TargetingSound)
 	{
@@ -762,6 +854,7 @@ void AShooterCharacter::ServerSetTargeting_Implementation(bool bNewTargeting)
 void AShooterCharacter::SetRunning(bool bNewRunning, bool bToggle)
 {
 	bWantsToRun = bNewRunning;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, bWantsToRun, this);
 	bWantsToRunToggled = bNewRunning && bToggle;
 
 	if (GetLocalRole() < ROLE_Authority)
@@ -974,8 +1067,8 @@ void AShooterCharacter::OnNextWeapon()
 	{
 		if (Inventory.Num() >= 2 && (CurrentWeapon == NULL || CurrentWeapon->GetCurrentState() != EWeaponState::Equipping))
 		{
-			const int32 CurrentWeaponIdx = Inventory.IndexOfByKey(CurrentWeapon);
-			AShooterWeapon* NextWeapon = Inventory[(CurrentWeaponIdx + 1) % Inventory.Num()];
+			const int32 CurrentWeaponIdx = Inventory.IndexOf(CurrentWeapon);
+			AShooterWeapon* NextWeapon = Inventory.GetWeapon((CurrentWeaponIdx + 1) % Inventory.Num());
 			EquipWeapon(NextWeapon);
 		}
 	}
@@ -988,8 +1081,8 @@ void AShooterCharacter::OnPrevWeapon()
 	{
 		if (Inventory.Num() >= 2 && (CurrentWeapon == NULL || CurrentWeapon->GetCurrentState() != EWeaponState::Equipping))
 		{
-			const int32 CurrentWeaponIdx = Inventory.IndexOfByKey(CurrentWeapon);
-			AShooterWeapon* PrevWeapon = Inventory[(CurrentWeaponIdx - 1 + Inventory.Num()) % Inventory.Num()];
+			const int32 CurrentWeaponIdx = Inventory.IndexOf(CurrentWeapon);
+			AShooterWeapon* PrevWeapon = Inventory.GetWeapon((CurrentWeaponIdx - 1 + Inventory.Num()) % Inventory.Num());
 			EquipWeapon(PrevWeapon);
 		}
 	}
@@ -1068,6 +1161,7 @@ void AShooterCharacter::Tick(float DeltaSeconds)
 			{
 				Health = this->GetMaxHealth();
 			}
+			SHOOTER_MARK_PROPERTY_DIRTY(AShooterCharacter, Health, this);
 		}
 	}
 
@@ -1107,12 +1201,12 @@ void AShooterCharacter::Tick(float DeltaSeconds)
 	    USoundNodeLocalPlayer::GetLocallyControlledActorCache().Add(UniqueID, bLocallyControlled);
 	});
 	
-	TArray<FVector> PointsToTest;
-	BuildPauseReplicationCheckPoints(PointsToTest);
-
 	if (NetVisualizeRelevancyTestPoints == 1)
 	{
-		for (FVector PointToTest : PointsToTest)
+		FVector PointsToTest[NumPauseReplicationCheckPoints];
+		BuildPauseReplicationCheckPoints(PointsToTest);
+
+		for (const FVector& PointToTest : PointsToTest)
 		{
 			DrawDebugSphere(GetWorld(), PointToTest, 10.0f, 8, FColor::Red);
 		}
@@ -1168,18 +1262,26 @@ void AShooterCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > &
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
+	// push model: only compared when marked dirty (SHOOTER_MARK_PROPERTY_DIRTY)
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
 	// only to local owner: weapon change requests are locally instigated, other clients don't need it
-	DOREPLIFETIME_CONDITION(AShooterCharacter, Inventory, COND_OwnerOnly);
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, Inventory, Params);
 
 	// everyone except local owner: flag change is locally instigated
-	DOREPLIFETIME_CONDITION(AShooterCharacter, bIsTargeting, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AShooterCharacter, bWantsToRun, COND_SkipOwner);
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, bIsTargeting, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, bWantsToRun, Params);
 
-	DOREPLIFETIME_CONDITION(AShooterCharacter, LastTakeHitInfo, COND_Custom);
+	Params.Condition = COND_Custom;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, LastTakeHitInfo, Params);
 
 	// everyone
-	DOREPLIFETIME(AShooterCharacter, CurrentWeapon);
-	DOREPLIFETIME(AShooterCharacter, Health);
+	Params.Condition = COND_None;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, CurrentWeapon, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterCharacter, Health, Params);
 }
 
 bool AShooterCharacter::IsReplicationPausedForConnection(const FNetViewer& ConnectionOwnerNetViewer)
@@ -1193,13 +1295,19 @@ bool AShooterCharacter::IsReplicationPausedForConnection(const FNetViewer& Conne
 		FRotator ViewRotation;
 		PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
 
+		FVector PointsToTest[NumPauseReplicationCheckPoints];
+		BuildPauseReplicationCheckPoints(PointsToTest);
+
+		// Traces are batched and cached per connection, see UShooterNetVisibilitySubsystem
+		if (UShooterNetVisibilitySubsystem* VisibilitySubsystem = GetWorld()->GetSubsystem<UShooterNetVisibilitySubsystem>())
+		{
+			return !VisibilitySubsystem->IsVisibleTo(PC, this, ViewLocation, PointsToTest);
+		}
+
 		FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(LineOfSight), true, PC->GetPawn());
 		CollisionParams.AddIgnoredActor(this);
 
-		TArray<FVector> PointsToTest;
-		BuildPauseReplicationCheckPoints(PointsToTest);
-
-		for (FVector PointToTest : PointsToTest)
+		for (const FVector& PointToTest : PointsToTest)
 		{
 			if (!GetWorld()->LineTraceTestByChannel(PointToTest, ViewLocation, ECC_Visibility, CollisionParams))
 			{
@@ -1230,7 +1338,7 @@ int32 AShooterCharacter::GetInventoryCount() const
 
 AShooterWeapon* AShooterCharacter::GetInventoryWeapon(int32 index) const
 {
-	return Inventory[index];
+	return Inventory.GetWeapon(index);
 }
 
 USkeletalMeshComponent* AShooterCharacter::GetPawnMesh() const
@@ -1296,19 +1404,20 @@ void AShooterCharacter::UpdateTeamColorsAllMIDs()
 	}
 }
 
-void AShooterCharacter::BuildPauseReplicationCheckPoints(TArray<FVector>& RelevancyCheckPoints)
+void AShooterCharacter::BuildPauseReplicationCheckPoints(FVector (&RelevancyCheckPoints)[NumPauseReplicationCheckPoints]) const
 {
-	FBoxSphereBounds Bounds = GetCapsuleComponent()->CalcBounds(GetCapsuleComponent()->GetComponentTransform());
-	FBox BoundingBox = Bounds.GetBox();
-	float XDiff = Bounds.BoxExtent.X * 2;
-	float YDiff = Bounds.BoxExtent.Y * 2;
+	// Bounds are cached by the component whenever it moves, no need to recalculate them here
+	const FBoxSphereBounds& Bounds = GetCapsuleComponent()->Bounds;
+	const FBox BoundingBox = Bounds.GetBox();
+	const float XDiff = Bounds.BoxExtent.X * 2;
+	const float YDiff = Bounds.BoxExtent.Y * 2;
 
-	RelevancyCheckPoints.Add(BoundingBox.Min);
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Min.X + XDiff, BoundingBox.Min.Y, BoundingBox.Min.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Min.X, BoundingBox.Min.Y + YDiff, BoundingBox.Min.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Min.X + XDiff, BoundingBox.Min.Y + YDiff, BoundingBox.Min.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Max.X - XDiff, BoundingBox.Max.Y, BoundingBox.Max.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Max.X, BoundingBox.Max.Y - YDiff, BoundingBox.Max.Z));
-	RelevancyCheckPoints.Add(FVector(BoundingBox.Max.X - XDiff, BoundingBox.Max.Y - YDiff, BoundingBox.Max.Z));
-	RelevancyCheckPoints.Add(BoundingBox.Max);
+	RelevancyCheckPoints[0] = BoundingBox.Min;
+	RelevancyCheckPoints[1] = FVector(BoundingBox.Min.X + XDiff, BoundingBox.Min.Y, BoundingBox.Min.Z);
+	RelevancyCheckPoints[2] = FVector(BoundingBox.Min.X, BoundingBox.Min.Y + YDiff, BoundingBox.Min.Z);
+	RelevancyCheckPoints[3] = FVector(BoundingBox.Min.X + XDiff, BoundingBox.Min.Y + YDiff, BoundingBox.Min.Z);
+	RelevancyCheckPoints[4] = FVector(BoundingBox.Max.X - XDiff, BoundingBox.Max.Y, BoundingBox.Max.Z);
+	RelevancyCheckPoints[5] = FVector(BoundingBox.Max.X, BoundingBox.Max.Y - YDiff, BoundingBox.Max.Z);
+	RelevancyCheckPoints[6] = FVector(BoundingBox.Max.X - XDiff, BoundingBox.Max.Y - YDiff, BoundingBox.Max.Z);
+	RelevancyCheckPoints[7] = BoundingBox.Max;
 }
\ No newline at end of file
@@ -3,6 +3,57 @@
 #include "ShooterGame.h"
 #include "Player/ShooterCharacter.h"
 #include "Player/ShooterCharacterMovement.h"
+#include "Player/ShooterLocalPlayer.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("ServerMove RPCs"), STAT_ShooterServerMoves, STATGROUP_Game);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Traces"), STAT_ShooterWallTraces, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Traces Cached"), STAT_ShooterWallTracesCached, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Probes"), STAT_ShooterWallProbes, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Wall Traces Per Second"), STAT_ShooterWallTracesPerSecond, STATGROUP_Game);
+
+static const FName NAME_Jump(TEXT("Jump"));
+
+// World wall traces of all characters since WallTraceWindowStartTime, STAT_ShooterWallTracesPerSecond is set from it about once a second.
+// Cached steps don't count, each of them still probes the cached wall component alone (STAT_ShooterWallProbes).
+static int32 NumWallTracesInWindow = 0;
+static double WallTraceWindowStartTime = 0.0;
+static uint64 WallTraceRateFrame = 0;
+
+static void CountWallTrace()
+{
+	INC_DWORD_STAT(STAT_ShooterWallTraces);
+	++NumWallTracesInWindow;
+}
+
+// Once per frame from the first movement component to tick, also on frames without traces
+static void UpdateWallTraceRate()
+{
+	if (WallTraceRateFrame == GFrameCounter)
+	{
+		return;
+	}
+	WallTraceRateFrame = GFrameCounter;
+
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = Now - WallTraceWindowStartTime;
+	if (Elapsed >= 1.0)
+	{
+		// the first window started whenever the first component ticked, don't report it
+		if (WallTraceWindowStartTime > 0.0)
+		{
+			SET_DWORD_STAT(STAT_ShooterWallTracesPerSecond, FMath::RoundToInt(NumWallTracesInWindow / Elapsed));
+		}
+		NumWallTracesInWindow = 0;
+		WallTraceWindowStartTime = Now;
+	}
+}
+
+// How far off its face a wall point may be and still be inside the wall's bounds, for the cached wall
+static const float WallCacheBoundsTolerance = 1.0f;
+
+// Wall directions closer than this per component are the same wall, moves along it can be combined
+static const float WallDirectionCombineTolerance = 0.02f;
 
 //----------------------------------------------------------------------//
 // Saved Move
@@ -19,6 +70,7 @@ void UShooterCharacterMovement::FSavedMove_ShooterCharacter::Clear()
 	// Wall Run
 	SavedWallDirection = FVector::ZeroVector;
 	SavedWallRunMovementDirection = FVector::ZeroVector;
+	bSavedHoldingJump = false;
 }
 
 uint8 UShooterCharacterMovement::FSavedMove_ShooterCharacter::GetCompressedFlags() const
@@ -31,11 +83,38 @@ uint8 UShooterCharacterMovement::FSavedMove_ShooterCharacter::GetCompressedFlags
 		Flags |= FLAG_Custom_0;
 	}
 
+	// Wall Run
+	if (bSavedHoldingJump)
+	{
+		Flags |= FLAG_Custom_1;
+	}
+
 	return Flags;
 }
 
 bool UShooterCharacterMovement::FSavedMove_ShooterCharacter::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* Character, float MaxDelta) const
 {
+	const FSavedMove_ShooterCharacter* NewShooterMove = static_cast<const FSavedMove_ShooterCharacter*>(NewMove.Get());
+
+	// Teleport, each one has to reach the server on its own
+	if (bSavedWantsToTeleport || NewShooterMove->bSavedWantsToTeleport)
+	{
+		return false;
+	}
+
+	// Wall Run, combined moves are replayed from the first one's start with the last one's wall, so it has to be the same wall
+	if (bSavedHoldingJump != NewShooterMove->bSavedHoldingJump)
+	{
+		return false;
+	}
+
+	if (!SavedWallDirection.Equals(NewShooterMove->SavedWallDirection, WallDirectionCombineTolerance) ||
+		!SavedWallRunMovementDirection.Equals(NewShooterMove->SavedWallRunMovementDirection, WallDirectionCombineTolerance))
+	{
+		return false;
+	}
+
+	// idle, straight line and movement mode rules
 	return Super::CanCombineWith(NewMove, Character, MaxDelta);
 }
 
@@ -53,6 +132,7 @@ void UShooterCharacterMovement::FSavedMove_ShooterCharacter::SetMoveFor(ACharact
 		// Wall Direction
 		SavedWallDirection = CharacterMovement->WallDirection;
 		SavedWallRunMovementDirection = CharacterMovement->WallRunMovementDirection;
+		bSavedHoldingJump = CharacterMovement->bHoldingJump;
 	}
 }
 
@@ -95,6 +175,12 @@ UShooterCharacterMovement::UShooterCharacterMovement(const FObjectInitializer& O
 	: Super(ObjectInitializer)
 {
 	DefaultGravity = GravityScale;
+	NumServerMovesSent = 0;
+	NumWallTraces = 0;
+	NumWallProbes = 0;
+
+	WallCacheTangentDistance = 100.0f;
+	bHasCachedWall = false;
 }
 
 void UShooterCharacterMovement::BeginPlay()
@@ -139,6 +225,19 @@ void UShooterCharacterMovement::UpdateFromCompressedFlags(uint8 Flags)
 
 	// Teleport
 	bWantsToTeleport = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+
+	// Wall Run
+	bHoldingJump = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+}
+
+void UShooterCharacterMovement::CallServerMove(const class FSavedMove_Character* NewMove, const class FSavedMove_Character* OldMove)
+{
+	Super::CallServerMove(NewMove, OldMove);
+
+	// an old important move goes out in its own ServerMoveOld
+	const int32 NumRPCs = OldMove ? 2 : 1;
+	NumServerMovesSent += NumRPCs;
+	INC_DWORD_STAT_BY(STAT_ShooterServerMoves, NumRPCs);
 }
 
 class FNetworkPredictionData_Client* UShooterCharacterMovement::GetPredictionData_Client() const
@@ -161,10 +260,11 @@ class FNetworkPredictionData_Client* UShooterCharacterMovement::GetPredictionDat
 
 void UShooterCharacterMovement::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	UpdateWallTraceRate();
+
 	if (PawnOwner && PawnOwner->IsLocallyControlled())
 	{
 		bHoldingJump = IsHoldingJump();
-		Server_HoldingJump(bHoldingJump);
 	}
 
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
@@ -193,6 +293,9 @@ void UShooterCharacterMovement::OnMovementUpdated(float DeltaTime, const FVector
 
 void UShooterCharacterMovement::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
 {
+	// every wall run traces its wall again
+	bHasCachedWall = false;
+
 	// changed to wall running
 	if (MovementMode == MOVE_Custom)
 	{
@@ -241,7 +344,7 @@ void UShooterCharacterMovement::PhysCustom(float deltaTime, int32 Iterations)
 
 		// Update velocity direction to be tangent to the wall
 		// If the wall bends to much, such as a corner, then stop wall run
-		FHitResult WallHit = CheckWallProximity(WallDirection);
+		FHitResult WallHit = FindWall(WallDirection);
 
 		if (WallHit.bBlockingHit && abs(FVector::DotProduct(WallDirection, WallHit.Normal)) > WallRunCornerVariance)
 		{
@@ -266,15 +369,11 @@ bool UShooterCharacterMovement::IsHoldingJump()
 {
 	if (PawnOwner && PawnOwner->IsLocallyControlled())
 	{
-		TArray<FInputActionKeyMapping> JumpKeyMappings;
-		UInputSettings::GetInputSettings()->GetActionMappingByName("Jump", JumpKeyMappings);
-		for (FInputActionKeyMapping& JumpKeyMapping : JumpKeyMappings)
+		const APlayerController* Controller = PawnOwner->GetController<APlayerController>();
+		UShooterLocalPlayer* LocalPlayer = Controller ? Cast<UShooterLocalPlayer>(Controller->GetLocalPlayer()) : nullptr;
+		if (LocalPlayer)
 		{
-			AShooterPlayerController* controller = PawnOwner->GetController<AShooterPlayerController>();
-			if (controller && controller->IsInputKeyDown(JumpKeyMapping.Key))
-			{
-				return true;
-			}
+			return LocalPlayer->IsActionKeyDown(NAME_Jump);
 		}
 	}
 
@@ -330,14 +429,9 @@ void UShooterCharacterMovement::Server_TeleportDirection_Implementation(const FV
 
 void UShooterCharacterMovement::StartWallRun(const FVector& Direction)
 {
-	if (PawnOwner && PawnOwner->IsLocallyControlled())
-	{
-		WallDirection = Direction.GetSafeNormal();
-		WallRunMovementDirection = FVector::VectorPlaneProject(Velocity, WallDirection).GetSafeNormal();
-
-		Server_WallDirection(WallDirection);
-		Server_WallRunMovementDirection(WallRunMovementDirection);
-	}
+	// the server hits the same wall replaying the move and corrects the client if it doesn't
+	WallDirection = Direction.GetSafeNormal();
+	WallRunMovementDirection = FVector::VectorPlaneProject(Velocity, WallDirection).GetSafeNormal();
 
 	SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::SHOOTERMOVE_WallRunning);
 }
@@ -358,11 +452,13 @@ FHitResult UShooterCharacterMovement::CheckWallProximity(FVector Direction)
 
 	FVector EndPoint = GetActorLocation() + (Direction * (CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleRadius() + WallMaxDistance));
 
-	// Trace parameters
-	FCollisionQueryParams TraceParams = FCollisionQueryParams(FName("WallTraceTag"), true, PawnOwner);
-	TraceParams.bTraceComplex = true;
+	// Trace parameters, simple collision is enough to find the wall's plane
+	FCollisionQueryParams TraceParams = FCollisionQueryParams(FName("WallTraceTag"), false, PawnOwner);
 	TraceParams.bReturnPhysicalMaterial = false;
-	TraceParams.bFindInitialOverlaps = true;
+	TraceParams.bFindInitialOverlaps = false;
+
+	CountWallTrace();
+	++NumWallTraces;
 
 	// Line trace
 	GetWorld()->LineTraceSingleByChannel(
@@ -376,32 +472,77 @@ FHitResult UShooterCharacterMovement::CheckWallProximity(FVector Direction)
 	return HitOut;
 }
 
-bool UShooterCharacterMovement::Server_WallDirection_Validate(const FVector& Direction)
+FHitResult UShooterCharacterMovement::FindWall(const FVector& Direction)
 {
-	return true;
-}
+	if (!CharacterOwner)
+	{
+		return FHitResult(ForceInit);
+	}
 
-void UShooterCharacterMovement::Server_WallDirection_Implementation(const FVector& Direction)
-{
-	WallDirection = Direction;
-}
+	const FVector Location = GetActorLocation();
+	const float CapsuleRadius = CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
 
-bool UShooterCharacterMovement::Server_WallRunMovementDirection_Validate(const FVector& Direction)
-{
-	return true;
-}
+	// The cached wall still holds while it is static, faces the same way and is within reach, and the character hasn't moved far enough along it to reach a corner
+	UPrimitiveComponent* WallComponent = CachedWallComponent.Get();
+	if (bHasCachedWall && WallComponent && WallComponent->Mobility == EComponentMobility::Static &&
+		FVector::DotProduct(Direction, CachedWallNormal) < -0.999f)
+	{
+		const float WallDistance = FVector::DotProduct(Location - CachedWallPoint, CachedWallNormal);
+		const FVector TangentMove = FVector::VectorPlaneProject(Location - CachedWallTraceLocation, CachedWallNormal);
+		const FVector WallPoint = Location - CachedWallNormal * WallDistance;
 
-void UShooterCharacterMovement::Server_WallRunMovementDirection_Implementation(const FVector& Direction)
-{
-	WallRunMovementDirection = Direction;
-}
+		if (WallDistance >= 0.0f && WallDistance <= CapsuleRadius + WallMaxDistance &&
+			TangentMove.SizeSquared() < FMath::Square(WallCacheTangentDistance) &&
+			IsOnCachedWall(WallComponent, WallPoint, CapsuleRadius))
+		{
+			INC_DWORD_STAT(STAT_ShooterWallTracesCached);
+
+			FHitResult CachedHit(Location, Location + Direction * WallDistance);
+			CachedHit.bBlockingHit = true;
+			CachedHit.Time = 0.0f;
+			CachedHit.Distance = WallDistance;
+			CachedHit.Location = WallPoint;
+			CachedHit.ImpactPoint = WallPoint;
+			CachedHit.Normal = CachedWallNormal;
+			CachedHit.ImpactNormal = CachedWallNormal;
+			CachedHit.Component = CachedWallComponent;
+			CachedHit.Actor = WallComponent->GetOwner();
+			return CachedHit;
+		}
+	}
 
-bool UShooterCharacterMovement::Server_HoldingJump_Validate(bool IsHoldingJump)
-{
-	return true;
+	FHitResult WallHit = CheckWallProximity(Direction);
+
+	bHasCachedWall = WallHit.bBlockingHit;
+	if (bHasCachedWall)
+	{
+		CachedWallPoint = WallHit.ImpactPoint;
+		CachedWallNormal = WallHit.ImpactNormal;
+		CachedWallTraceLocation = Location;
+		CachedWallComponent = WallHit.Component;
+	}
+
+	return WallHit;
 }
 
-void UShooterCharacterMovement::Server_HoldingJump_Implementation(bool IsHoldingJump)
+bool UShooterCharacterMovement::IsOnCachedWall(UPrimitiveComponent* WallComponent, const FVector& WallPoint, float CapsuleRadius)
 {
-	bHoldingJump = IsHoldingJump;
+	// The capsule has to be a radius away from the edges of the wall's bounds, shrunk along the wall only (WallPoint is on its face)
+	const FVector AlongNormal = CachedWallNormal.GetAbs();
+	const FVector Shrink = (FVector::OneVector - AlongNormal) * CapsuleRadius - AlongNormal * WallCacheBoundsTolerance;
+	if (!WallComponent->Bounds.GetBox().ExpandBy(-Shrink).IsInsideOrOn(WallPoint))
+	{
+		return false;
+	}
+
+	// Bounds can be bigger than the wall (rotated, not a box, gaps), probe the wall alone in front of the capsule's leading edge
+	const FVector MoveDirection = FVector::VectorPlaneProject(Velocity, CachedWallNormal).GetSafeNormal();
+	const FVector ProbeStart = GetActorLocation() + MoveDirection * CapsuleRadius;
+	const FVector ProbeEnd = ProbeStart - CachedWallNormal * (CapsuleRadius + WallMaxDistance);
+
+	INC_DWORD_STAT(STAT_ShooterWallProbes);
+	++NumWallProbes;
+
+	FHitResult ProbeHit;
+	return WallComponent->LineTraceComponent(ProbeHit, ProbeStart, ProbeEnd, FCollisionQueryParams(FName("WallProbeTag"), false, PawnOwner));
 }
@@ -54,6 +54,43 @@ void UShooterLocalPlayer::LoadPersistentUser()
 	}
 }
 
+bool UShooterLocalPlayer::IsActionKeyDown(FName ActionName)
+{
+	if (PlayerController == nullptr || PlayerController->PlayerInput == nullptr)
+	{
+		return false;
+	}
+
+	const TArray<FKey>* Keys = ActionKeys.Find(ActionName);
+	if (Keys == nullptr)
+	{
+		TArray<FKey>& NewKeys = ActionKeys.Add(ActionName);
+		for (const FInputActionKeyMapping& Mapping : PlayerController->PlayerInput->ActionMappings)
+		{
+			if (Mapping.ActionName == ActionName)
+			{
+				NewKeys.AddUnique(Mapping.Key);
+			}
+		}
+		Keys = &NewKeys;
+	}
+
+	for (const FKey& Key : *Keys)
+	{
+		if (PlayerController->IsInputKeyDown(Key))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UShooterLocalPlayer::InvalidateInputBindings()
+{
+	ActionKeys.Reset();
+}
+
 void UShooterLocalPlayer::SetControllerId(int32 NewControllerId)
 {
 	ULocalPlayer::SetControllerId(NewControllerId);
@@ -178,6 +178,8 @@ void UShooterPersistentUser::TellInputAboutKeybindings()
 			continue;
 		}
 
+		LocalPlayer->InvalidateInputBindings();
+
 		//set the aim sensitivity
 		for (int32 Idx = 0; Idx < PC->PlayerInput->AxisMappings.Num(); Idx++)
 		{
@@ -62,4 +62,114 @@ void FTakeHitInfo::SetDamageEvent(const FDamageEvent& DamageEvent)
 void FTakeHitInfo::EnsureReplication()
 {
 	EnsureReplicationByte++;
-}
\ No newline at end of file
+}
+
+namespace
+{
+	/** Which of the damage events is sent, 2 bits on the wire */
+	enum class ETakeHitEventType : uint8
+	{
+		General,
+		Point,
+		Radial,
+	};
+}
+
+bool FTakeHitInfo::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint8 EventType = (uint8)ETakeHitEventType::General;
+	if (Ar.IsSaving())
+	{
+		if (DamageEventClassID == FPointDamageEvent::ClassID)
+		{
+			EventType = (uint8)ETakeHitEventType::Point;
+		}
+		else if (DamageEventClassID == FRadialDamageEvent::ClassID)
+		{
+			EventType = (uint8)ETakeHitEventType::Radial;
+		}
+	}
+	Ar.SerializeBits(&EventType, 2);
+
+	uint8 bKilledBit = bKilled;
+	Ar.SerializeBits(&bKilledBit, 1);
+
+	// Still sent so a client receiving the same hit twice in a row sees a change and calls OnRep
+	Ar << EnsureReplicationByte;
+
+	// Tenths of a point are plenty for the HUD indicator
+	uint32 DamageTenths = Ar.IsSaving() ? (uint32)FMath::RoundToInt(FMath::Clamp(ActualDamage, 0.f, 100000000.f) * 10.f) : 0;
+	Ar.SerializeIntPacked(DamageTenths);
+
+	UObject* DamageTypeObject = DamageTypeClass;
+	Ar << DamageTypeObject;
+	Ar << PawnInstigator;
+	Ar << DamageCauser;
+
+	FVector_NetQuantizeNormal ShotDirection;
+	FVector_NetQuantize Origin;
+	FVector_NetQuantize ImpactPoint;
+	bool bSerializedVector = true;
+
+	switch ((ETakeHitEventType)EventType)
+	{
+	case ETakeHitEventType::Point:
+		ShotDirection = PointDamageEvent.ShotDirection;
+		ShotDirection.NetSerialize(Ar, Map, bSerializedVector);
+		bOutSuccess &= bSerializedVector;
+		break;
+
+	case ETakeHitEventType::Radial:
+		// Clients only look at the first component hit, to get the impulse direction from the origin
+		Origin = RadialDamageEvent.Origin;
+		ImpactPoint = RadialDamageEvent.ComponentHits.Num() > 0 ? RadialDamageEvent.ComponentHits[0].ImpactPoint : RadialDamageEvent.Origin;
+		Origin.NetSerialize(Ar, Map, bSerializedVector);
+		bOutSuccess &= bSerializedVector;
+		ImpactPoint.NetSerialize(Ar, Map, bSerializedVector);
+		bOutSuccess &= bSerializedVector;
+		break;
+
+	default:
+		break;
+	}
+
+	if (Ar.IsLoading())
+	{
+		bKilled = bKilledBit;
+		ActualDamage = DamageTenths / 10.f;
+		DamageTypeClass = Cast<UClass>(DamageTypeObject);
+
+		// Events get their damage type from DamageTypeClass in GetDamageEvent
+		switch ((ETakeHitEventType)EventType)
+		{
+		case ETakeHitEventType::Point:
+			DamageEventClassID = FPointDamageEvent::ClassID;
+			PointDamageEvent = FPointDamageEvent();
+			PointDamageEvent.Damage = ActualDamage;
+			PointDamageEvent.ShotDirection = ShotDirection;
+			break;
+
+		case ETakeHitEventType::Radial:
+		{
+			DamageEventClassID = FRadialDamageEvent::ClassID;
+			RadialDamageEvent = FRadialDamageEvent();
+			RadialDamageEvent.Origin = Origin;
+
+			FHitResult& Hit = RadialDamageEvent.ComponentHits.AddDefaulted_GetRef();
+			Hit.bBlockingHit = true;
+			Hit.ImpactPoint = ImpactPoint;
+			Hit.Location = ImpactPoint;
+			break;
+		}
+
+		default:
+			DamageEventClassID = FDamageEvent::ClassID;
+			GeneralDamageEvent = FDamageEvent();
+			break;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "Components/BoxComponent.h"
+#include "Bots/ShooterBot.h"
+#include "Bots/ShooterBotMovementLODSubsystem.h"
+#include "Tests/ShooterTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterBotMovementLODTest
+{
+	const int32 BotCounts[] = { 16, 32, 64, 128 };
+	const int32 NumWarmupFrames = 30;
+	const int32 NumFrames = 120;
+	const float DeltaTime = 1.f / 60.f;
+
+	/** runs every bot along its row and ticks the world, returns the seconds it took */
+	double TickWorld(UWorld* World, const TArray<AShooterBot*>& Bots, int32 Frames)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < Frames; ++Frame)
+		{
+			for (AShooterBot* Bot : Bots)
+			{
+				Bot->AddMovementInput(FVector(0.f, 1.f, 0.f));
+			}
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterBotMovementLODBenchmark, "ShooterGame.Net.BotMovementLOD.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterBotMovementLODBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace ShooterBotMovementLODTest;
+
+	IConsoleVariable* LODVar = IConsoleManager::Get().FindConsoleVariable(TEXT("p.BotMovementLOD"));
+	if (!TestNotNull(TEXT("p.BotMovementLOD"), LODVar))
+	{
+		return false;
+	}
+	const int32 SavedLOD = LODVar->GetInt();
+
+	FShooterTestWorld TestWorld(TEXT("ShooterBotMovementLODTest"));
+	UWorld* World = TestWorld.Get();
+
+	UShooterBotMovementLODSubsystem* MovementLOD = World->GetSubsystem<UShooterBotMovementLODSubsystem>();
+
+	// ground to walk on, its top at Z = 0
+	AActor* Floor = World->SpawnActor<AActor>();
+	UBoxComponent* FloorBox = NewObject<UBoxComponent>(Floor);
+	FloorBox->SetBoxExtent(FVector(50000.f, 50000.f, 100.f));
+	FloorBox->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	Floor->SetRootComponent(FloorBox);
+	FloorBox->RegisterComponent();
+	Floor->SetActorLocation(FVector(0.f, 0.f, -100.f));
+
+	// the only human viewer, at the origin: bots spread out to twice their net cull distance, about half of them near it
+	World->SpawnActor<APlayerController>(FVector::ZeroVector, FRotator::ZeroRotator);
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const float CullDistance = FMath::Sqrt(GetDefault<AShooterBot>()->NetCullDistanceSquared);
+
+	AddInfo(TEXT("Bots: full rate ms per frame / with movement LOD ms per frame (bots at reduced rate)"));
+
+	for (const int32 NumBots : BotCounts)
+	{
+		TArray<AShooterBot*> Bots;
+		for (int32 Idx = 0; Idx < NumBots; ++Idx)
+		{
+			const FVector Location(2.f * CullDistance * Idx / NumBots, (Idx % 8) * 300.f, 200.f);
+
+			AShooterBot* Bot = World->SpawnActor<AShooterBot>(AShooterBot::StaticClass(), Location, FRotator::ZeroRotator, SpawnInfo);
+			if (Bot)
+			{
+				// no AI controller, the benchmark drives the bots itself
+				Bot->GetCharacterMovement()->bRunPhysicsWithNoController = true;
+				MovementLOD->Register(Bot);
+				Bots.Add(Bot);
+			}
+		}
+
+		LODVar->Set(0);
+		TickWorld(World, Bots, NumWarmupFrames);
+		const double FullSeconds = TickWorld(World, Bots, NumFrames);
+		TestEqual(FString::Printf(TEXT("%d bots all at full rate without movement LOD"), NumBots), MovementLOD->GetNumReducedBots(), 0);
+
+		LODVar->Set(1);
+		TickWorld(World, Bots, NumWarmupFrames);
+		const int32 NumReduced = MovementLOD->GetNumReducedBots();
+		const double LODSeconds = TickWorld(World, Bots, NumFrames);
+		TestTrue(FString::Printf(TEXT("%d bots: some near the viewer, some reduced"), NumBots), NumReduced > 0 && NumReduced < Bots.Num());
+
+		AddInfo(FString::Printf(TEXT("%4d: %.3fms / %.3fms (%d)"), Bots.Num(), FullSeconds * 1000.0 / NumFrames, LODSeconds * 1000.0 / NumFrames, NumReduced));
+
+		for (AShooterBot* Bot : Bots)
+		{
+			Bot->Destroy();
+		}
+	}
+
+	LODVar->Set(SavedLOD);
+
+	return true;
+}
+
+#endif
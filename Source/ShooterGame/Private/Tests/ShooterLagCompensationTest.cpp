@@ -0,0 +1,152 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "Online/ShooterLagCompensationSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterLagCompensationTest
+{
+	/** a pawn roughly like the hero: capsule plus a stack of boxes along its spine, facing +X */
+	void InitHistory(FShooterHitboxHistory& History)
+	{
+		FName Bones[FShooterHitboxHistory::MaxHitboxes];
+		FBox LocalBoxes[FShooterHitboxHistory::MaxHitboxes];
+		for (int32 Idx = 0; Idx < FShooterHitboxHistory::MaxHitboxes; ++Idx)
+		{
+			Bones[Idx] = FName(TEXT("bone"), Idx);
+			LocalBoxes[Idx] = FBox(FVector(-8.f), FVector(8.f));
+		}
+		History.Init(34.f, 88.f, Bones, LocalBoxes);
+	}
+
+	/** hitboxes 10cm apart going up from the capsule's bottom */
+	void MakeHitboxTransforms(const FVector& CapsuleLocation, TArrayView<FTransform> OutTransforms)
+	{
+		for (int32 Idx = 0; Idx < OutTransforms.Num(); ++Idx)
+		{
+			OutTransforms[Idx] = FTransform(FQuat::Identity, CapsuleLocation + FVector(0.f, 0.f, -80.f + Idx * 10.f));
+		}
+	}
+
+	/** pawn running along +X at 600 cm/s, sampled at 30 Hz */
+	FVector GetRunnerLocation(float Time)
+	{
+		return FVector(600.f * Time, 0.f, 100.f);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterLagCompensationTest, "ShooterGame.Net.LagCompensation", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FShooterLagCompensationTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterLagCompensationTest;
+
+	TUniquePtr<FShooterHitboxHistory> History = MakeUnique<FShooterHitboxHistory>();
+	InitHistory(*History);
+
+	FShooterHitboxHistory::FFrame Frame;
+	TestFalse(TEXT("Nothing to sample before recording"), History->Sample(0.f, Frame));
+
+	FTransform Transforms[FShooterHitboxHistory::MaxHitboxes];
+	const float FrameTime = 1.f / 30.f;
+	const int32 NumRecorded = FShooterHitboxHistory::MaxFrames + 10;
+	for (int32 FrameIdx = 0; FrameIdx < NumRecorded; ++FrameIdx)
+	{
+		const float Time = FrameIdx * FrameTime;
+		MakeHitboxTransforms(GetRunnerLocation(Time), Transforms);
+		History->Record(Time, GetRunnerLocation(Time), Transforms);
+	}
+
+	const float Now = (NumRecorded - 1) * FrameTime;
+	TestEqual(TEXT("Ring buffer keeps MaxFrames"), History->GetNumFrames(), FShooterHitboxHistory::MaxFrames);
+	TestEqual(TEXT("Oldest frame"), History->GetOldestTime(), (NumRecorded - FShooterHitboxHistory::MaxFrames) * FrameTime, KINDA_SMALL_NUMBER);
+
+	// between two recorded frames
+	const float RewoundTime = Now - 0.15f - FrameTime * 0.5f;
+	TestTrue(TEXT("Sample between frames"), History->Sample(RewoundTime, Frame));
+	TestTrue(TEXT("Capsule interpolated"), Frame.CapsuleLocation.Equals(GetRunnerLocation(RewoundTime), 0.1f));
+	TestTrue(TEXT("Hitbox interpolated"), Frame.HitboxLocations[3].Equals(GetRunnerLocation(RewoundTime) + FVector(0.f, 0.f, -50.f), 0.1f));
+
+	// the shot was on target when the client fired, but the target has moved 100cm since
+	const FVector ClientHit = GetRunnerLocation(RewoundTime) + FVector(0.f, 0.f, -50.f);
+	TestTrue(TEXT("Hit on the rewound hitbox"), History->IsNear(RewoundTime, ClientHit, FName(TEXT("bone"), 3), 1.f));
+	TestFalse(TEXT("Same hit is off the current hitbox"), History->IsNear(Now, ClientHit, FName(TEXT("bone"), 3), 1.f));
+	TestFalse(TEXT("Hit on another hitbox than the reported bone"), History->IsNear(RewoundTime, ClientHit + FVector(0.f, 0.f, 60.f), FName(TEXT("bone"), 3), 1.f));
+	TestTrue(TEXT("Hit without a bone tests every hitbox"), History->IsNear(RewoundTime, ClientHit + FVector(0.f, 0.f, 60.f), NAME_None, 1.f));
+	TestTrue(TEXT("Hit without a bone falls back to the capsule"), History->IsNear(RewoundTime, GetRunnerLocation(RewoundTime) + FVector(0.f, 30.f, 0.f), NAME_None, 0.f));
+	TestFalse(TEXT("Leeway is honored"), History->IsNear(RewoundTime, ClientHit + FVector(0.f, 20.f, 0.f), FName(TEXT("bone"), 3), 5.f));
+	TestTrue(TEXT("Leeway is honored"), History->IsNear(RewoundTime, ClientHit + FVector(0.f, 20.f, 0.f), FName(TEXT("bone"), 3), 15.f));
+
+	// outside the recorded range
+	TestTrue(TEXT("Clamped to the newest frame"), History->Sample(Now + 1.f, Frame) && Frame.CapsuleLocation.Equals(GetRunnerLocation(Now)));
+	TestTrue(TEXT("Clamped to the oldest frame"), History->Sample(0.f, Frame) && Frame.CapsuleLocation.Equals(GetRunnerLocation(History->GetOldestTime())));
+
+	// time going back drops the history
+	History->Record(0.f, FVector::ZeroVector, Transforms);
+	TestEqual(TEXT("Restarted world time resets the history"), History->GetNumFrames(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterLagCompensationBenchmark, "ShooterGame.Net.LagCompensation.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterLagCompensationBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace ShooterLagCompensationTest;
+
+	const int32 NumPawns = 64;
+	const int32 NumFrames = 1000;
+	const int32 NumQueries = 100000;
+
+	TArray<TUniquePtr<FShooterHitboxHistory>> Histories;
+	for (int32 PawnIdx = 0; PawnIdx < NumPawns; ++PawnIdx)
+	{
+		Histories.Add(MakeUnique<FShooterHitboxHistory>());
+		InitHistory(*Histories.Last());
+	}
+
+	const float FrameTime = 1.f / 30.f;
+	FTransform Transforms[FShooterHitboxHistory::MaxHitboxes];
+
+	// what the subsystem does every server frame, minus reading the bone transforms
+	const double RecordStart = FPlatformTime::Seconds();
+	for (int32 FrameIdx = 0; FrameIdx < NumFrames; ++FrameIdx)
+	{
+		const float Time = FrameIdx * FrameTime;
+		for (int32 PawnIdx = 0; PawnIdx < NumPawns; ++PawnIdx)
+		{
+			const FVector Location = GetRunnerLocation(Time) + FVector(0.f, PawnIdx * 100.f, 0.f);
+			MakeHitboxTransforms(Location, Transforms);
+			Histories[PawnIdx]->Record(Time, Location, Transforms);
+		}
+	}
+	const double RecordSeconds = FPlatformTime::Seconds() - RecordStart;
+
+	// hit checks at random pawns and rewind times, like a server full of shooters with pings up to 300ms
+	FRandomStream RandomStream(0x5107);
+	const float Now = (NumFrames - 1) * FrameTime;
+	int32 NumNear = 0;
+
+	const double QueryStart = FPlatformTime::Seconds();
+	for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+	{
+		const int32 PawnIdx = RandomStream.RandHelper(NumPawns);
+		const float Time = Now - RandomStream.FRandRange(0.f, 0.3f);
+		const FVector Location = GetRunnerLocation(Time) + FVector(0.f, PawnIdx * 100.f, RandomStream.FRandRange(-80.f, 80.f));
+		NumNear += Histories[PawnIdx]->IsNear(Time, Location, FName(TEXT("bone"), RandomStream.RandHelper(FShooterHitboxHistory::MaxHitboxes + 4)), 20.f) ? 1 : 0;
+	}
+	const double QuerySeconds = FPlatformTime::Seconds() - QueryStart;
+
+	AddInfo(FString::Printf(TEXT("Record: %.3fms per server frame for %d pawns with %d hitboxes (%.0fns per pawn)"),
+		RecordSeconds * 1000.0 / NumFrames, NumPawns, FShooterHitboxHistory::MaxHitboxes, RecordSeconds * 1e9 / (NumFrames * NumPawns)));
+	AddInfo(FString::Printf(TEXT("Query: %.0fns per rewound hit check (%d of %d near)"), QuerySeconds * 1e9 / NumQueries, NumNear, NumQueries));
+	AddInfo(FString::Printf(TEXT("Memory: %d bytes per pawn, %d for %d pawns"), (int32)sizeof(FShooterHitboxHistory), (int32)sizeof(FShooterHitboxHistory) * NumPawns, NumPawns));
+
+	TestTrue(TEXT("Hits on the rewound pawns are found"), NumNear > 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,175 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "Components/BoxComponent.h"
+#include "Weapons/ShooterProjectileManager.h"
+#include "Tests/ShooterTestActors.h"
+#include "Tests/ShooterTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterProjectileManagerTest
+{
+	const int32 NumProjectiles = 500;
+	const int32 NumFrames = 120;
+	const float DeltaTime = 1.f / 60.f;
+	const float Speed = 2000.f;
+
+	/** spread over a grid high above the (empty) world, flying in all directions but down */
+	void GetLaunch(int32 Idx, FVector& OutOrigin, FVector& OutDirection)
+	{
+		OutOrigin = FVector((Idx % 25) * 400.f, (Idx / 25) * 400.f, 5000.f);
+		OutDirection = FRotator(FMath::Fmod(Idx * 7.f, 60.f), Idx * 37.f, 0.f).Vector();
+	}
+
+	double TickWorld(UWorld* World)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	/** box of half size Extent at Location, colliding as ProfileName */
+	AActor* SpawnBox(UWorld* World, const FVector& Location, const FVector& Extent, FName ProfileName)
+	{
+		AActor* Box = World->SpawnActor<AActor>();
+		UBoxComponent* BoxComp = NewObject<UBoxComponent>(Box);
+		BoxComp->SetBoxExtent(Extent);
+		BoxComp->SetCollisionProfileName(ProfileName);
+		Box->SetRootComponent(BoxComp);
+		BoxComp->RegisterComponent();
+		Box->SetActorLocation(Location);
+		return Box;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterProjectileManagerBenchmark, "ShooterGame.Net.ProjectileManager.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FShooterProjectileManagerBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace ShooterProjectileManagerTest;
+
+	FShooterTestWorld TestWorld(TEXT("ShooterProjectileManagerTest"));
+	UWorld* World = TestWorld.Get();
+
+	// everything the world does without projectiles, taken off the actor path below
+	const double EmptySeconds = TickWorld(World);
+
+	// actor path: one projectile actor each, moved by its movement component. Native test class, the gameplay one is abstract.
+	UClass* ProjectileClass = AShooterTestProjectile::StaticClass();
+
+	TArray<AShooterProjectile*> Actors;
+	const double ActorSpawnStart = FPlatformTime::Seconds();
+	for (int32 Idx = 0; Idx < NumProjectiles; ++Idx)
+	{
+		FVector Origin, Direction;
+		GetLaunch(Idx, Origin, Direction);
+
+		const FTransform SpawnTM(Direction.Rotation(), Origin);
+		AShooterProjectile* Projectile = World->SpawnActorDeferred<AShooterProjectile>(ProjectileClass, SpawnTM);
+		if (Projectile)
+		{
+			Projectile->InitVelocity(Direction);
+			UGameplayStatics::FinishSpawningActor(Projectile, SpawnTM);
+			Actors.Add(Projectile);
+		}
+	}
+	const double ActorSpawnSeconds = FPlatformTime::Seconds() - ActorSpawnStart;
+
+	const double ActorSeconds = FMath::Max(TickWorld(World) - EmptySeconds, 0.0);
+
+	int32 NumActorsMoved = 0;
+	for (int32 Idx = 0; Idx < Actors.Num(); ++Idx)
+	{
+		FVector Origin, Direction;
+		GetLaunch(Idx, Origin, Direction);
+		NumActorsMoved += FVector::DistSquared(Actors[Idx]->GetActorLocation(), Origin) > 1.f ? 1 : 0;
+		Actors[Idx]->Destroy();
+	}
+
+	// manager path: the same projectiles in FShooterProjectileSimulation, stepped the way AShooterProjectileManager::Tick does
+	FShooterProjectileSimulation Simulation;
+	const double SimulationSpawnStart = FPlatformTime::Seconds();
+	for (int32 Idx = 0; Idx < NumProjectiles; ++Idx)
+	{
+		FVector Origin, Direction;
+		GetLaunch(Idx, Origin, Direction);
+		Simulation.Add(Origin, Direction * Speed, 5.f, 10.f, NULL, NULL, 0);
+	}
+	const double SimulationSpawnSeconds = FPlatformTime::Seconds() - SimulationSpawnStart;
+
+	TArray<FShooterProjectileSimulation::FImpact> Impacts;
+	TArray<int32> ExpiredIds;
+	const double SimulationStart = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		Simulation.Step(World, DeltaTime, Impacts, ExpiredIds);
+	}
+	const double SimulationSeconds = FPlatformTime::Seconds() - SimulationStart;
+
+	TestEqual(TEXT("Actor projectiles spawned"), Actors.Num(), NumProjectiles);
+	TestEqual(TEXT("Actor projectiles moved"), NumActorsMoved, Actors.Num());
+	TestTrue(TEXT("Nothing to hit in an empty world"), Impacts.Num() == 0 && ExpiredIds.Num() == 0 && Simulation.Num() == NumProjectiles);
+
+	int32 NumOffCourse = 0;
+	for (int32 Idx = 0; Idx < Simulation.Num(); ++Idx)
+	{
+		FVector Origin, Direction;
+		GetLaunch(Simulation.Ids[Idx] - 1, Origin, Direction);
+		NumOffCourse += Simulation.Locations[Idx].Equals(Origin + Direction * Speed * DeltaTime * NumFrames, 1.f) ? 0 : 1;
+	}
+	TestEqual(TEXT("Simulated projectiles flew straight"), NumOffCourse, 0);
+
+	const int32 SimulationBytes = sizeof(int32) * 2 + sizeof(FVector) * 2 + sizeof(float) * 2 + sizeof(TWeakObjectPtr<UObject>) * 2;
+
+	AddInfo(FString::Printf(TEXT("%d projectiles, %d frames"), NumProjectiles, NumFrames));
+	AddInfo(FString::Printf(TEXT("Actors: %.3fms per frame (world tick minus %.3fms empty), spawning took %.2fms"),
+		ActorSeconds * 1000.0 / NumFrames, EmptySeconds * 1000.0 / NumFrames, ActorSpawnSeconds * 1000.0));
+	AddInfo(FString::Printf(TEXT("Manager: %.3fms per frame, adding took %.2fms, %d bytes of simulation state per projectile"),
+		SimulationSeconds * 1000.0 / NumFrames, SimulationSpawnSeconds * 1000.0, SimulationBytes));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterProjectileManagerTriggerTest, "ShooterGame.Net.ProjectileManager.Trigger", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FShooterProjectileManagerTriggerTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterProjectileManagerTest;
+
+	FShooterTestWorld TestWorld(TEXT("ShooterProjectileManagerTriggerTest"));
+	UWorld* World = TestWorld.Get();
+
+	// a trigger volume and an overlap only shape in the way, both flown through by projectile actors, then a wall
+	const FVector Extent(100.f, 500.f, 500.f);
+	AActor* Trigger = SpawnBox(World, FVector(500.f, 0.f, 0.f), Extent, FName(TEXT("Trigger")));
+	AActor* OverlapOnly = SpawnBox(World, FVector(1000.f, 0.f, 0.f), Extent, FName(TEXT("OverlapAllDynamic")));
+	AActor* Wall = SpawnBox(World, FVector(1500.f, 0.f, 0.f), Extent, UCollisionProfile::BlockAll_ProfileName);
+
+	FShooterProjectileSimulation Simulation;
+	Simulation.Add(FVector::ZeroVector, FVector(Speed, 0.f, 0.f), 5.f, 10.f, NULL, NULL, 0);
+
+	TArray<FShooterProjectileSimulation::FImpact> Impacts;
+	TArray<int32> ExpiredIds;
+	for (int32 Frame = 0; Frame < NumFrames && Impacts.Num() == 0; ++Frame)
+	{
+		Simulation.Step(World, DeltaTime, Impacts, ExpiredIds);
+	}
+
+	TestTrue(TEXT("Test actors spawned"), Trigger && OverlapOnly && Wall);
+	if (TestEqual(TEXT("Exploded once"), Impacts.Num(), 1))
+	{
+		const AActor* HitActor = Impacts[0].Hit.GetActor();
+		TestTrue(TEXT("Flew through the trigger"), HitActor != Trigger);
+		TestTrue(TEXT("Flew through the overlap only shape"), HitActor != OverlapOnly);
+		TestTrue(TEXT("Exploded on the wall"), HitActor == Wall);
+	}
+
+	return true;
+}
+
+#endif
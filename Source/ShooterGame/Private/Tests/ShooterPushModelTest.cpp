@@ -0,0 +1,182 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "Online/ShooterPushModel.h"
+#include "Online/ShooterPlayerState.h"
+#include "Tests/ShooterTestActors.h"
+#include "Tests/ShooterTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterPushModelTest
+{
+	/** Copy of the replicated properties ShooterGame declares on an object, to find the ones a gameplay call changed */
+	class FSnapshot
+	{
+	public:
+
+		explicit FSnapshot(UObject* InObject)
+			: Object(InObject)
+		{
+			TArray<FLifetimeProperty> LifetimeProps;
+			Object->GetLifetimeReplicatedProps(LifetimeProps);
+
+			UClass* Class = Object->GetClass();
+			for (const FLifetimeProperty& LifetimeProp : LifetimeProps)
+			{
+				FProperty* Property = Class->ClassReps[LifetimeProp.RepIndex].Property;
+
+				// Engine base classes are not ours to convert
+				if (Property->GetOwnerClass()->GetOutermost() != AShooterCharacter::StaticClass()->GetOutermost() || Values.ContainsByPredicate([&](const FValue& Value) { return Value.Property == Property; }))
+				{
+					continue;
+				}
+
+				FValue& Value = Values.AddDefaulted_GetRef();
+				Value.Property = Property;
+				Value.bIsPushBased = LifetimeProp.bIsPushBased;
+				Value.Data.SetNumZeroed(Property->ElementSize * Property->ArrayDim);
+				Property->InitializeValue(Value.Data.GetData());
+				Property->CopyCompleteValue(Value.Data.GetData(), Property->ContainerPtrToValuePtr<void>(Object));
+			}
+		}
+
+		~FSnapshot()
+		{
+			for (FValue& Value : Values)
+			{
+				Value.Property->DestroyValue(Value.Data.GetData());
+			}
+		}
+
+		/** Errors for every property that changed since the snapshot without being marked dirty. Changed properties are added to Exercised. */
+		void Verify(FAutomationTestBase& Test, const TCHAR* What, TSet<FProperty*>& Exercised) const
+		{
+			for (const FValue& Value : Values)
+			{
+				bool bChanged = false;
+				for (int32 Idx = 0; Idx < Value.Property->ArrayDim && !bChanged; ++Idx)
+				{
+					bChanged = !Value.Property->Identical(Value.Data.GetData() + Idx * Value.Property->ElementSize, Value.Property->ContainerPtrToValuePtr<void>(Object, Idx));
+				}
+
+				if (!bChanged)
+				{
+					continue;
+				}
+
+				Exercised.Add(Value.Property);
+
+				if (!Value.bIsPushBased)
+				{
+					Test.AddError(FString::Printf(TEXT("%s: %s::%s is replicated but not push based"), What, *Value.Property->GetOwnerClass()->GetName(), *Value.Property->GetName()));
+				}
+				else if (!FShooterPushModelTracker::WasMarked(Object, Value.Property->GetFName()))
+				{
+					Test.AddError(FString::Printf(TEXT("%s: %s::%s changed without being marked dirty"), What, *Value.Property->GetOwnerClass()->GetName(), *Value.Property->GetName()));
+				}
+			}
+		}
+
+		void GetProperties(TSet<FProperty*>& OutProperties) const
+		{
+			for (const FValue& Value : Values)
+			{
+				OutProperties.Add(Value.Property);
+			}
+		}
+
+	private:
+
+		struct FValue
+		{
+			FProperty* Property = nullptr;
+			bool bIsPushBased = false;
+			TArray<uint8> Data;
+		};
+
+		UObject* Object;
+		TArray<FValue> Values;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterPushModelTest, "ShooterGame.Net.PushModel", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FShooterPushModelTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterPushModelTest;
+
+	FShooterTestWorld TestWorld(TEXT("ShooterPushModelTest"));
+	UWorld* World = TestWorld.Get();
+
+	// native test classes, the gameplay ones are abstract
+	AShooterCharacter* Character = World->SpawnActor<AShooterTestCharacter>();
+	AShooterWeapon* Weapon = World->SpawnActor<AShooterTestWeapon_Instant>();
+	AShooterPlayerState* PlayerState = World->SpawnActor<AShooterPlayerState>();
+	AShooterPlayerState* OtherPlayerState = World->SpawnActor<AShooterPlayerState>();
+	AShooterPickup_Health* HealthPickup = World->SpawnActor<AShooterTestPickup_Health>();
+
+	if (!TestTrue(TEXT("Spawned test actors"), Character && Weapon && PlayerState && OtherPlayerState && HealthPickup))
+	{
+		return false;
+	}
+
+	TArray<UObject*> Objects = { Character, Weapon, PlayerState, OtherPlayerState, HealthPickup };
+	TSet<FProperty*> Exercised;
+
+	// Snapshots everything, runs a gameplay call and checks that whatever it changed was marked dirty
+	auto Check = [&](const TCHAR* What, TFunctionRef<void()> Mutate)
+	{
+		TArray<TUniquePtr<FSnapshot>> Snapshots;
+		for (UObject* Object : Objects)
+		{
+			Snapshots.Add(MakeUnique<FSnapshot>(Object));
+		}
+
+		FShooterPushModelTracker::StartRecording();
+		Mutate();
+		FShooterPushModelTracker::StopRecording();
+
+		for (const TUniquePtr<FSnapshot>& Snapshot : Snapshots)
+		{
+			Snapshot->Verify(*this, What, Exercised);
+		}
+	};
+
+	Check(TEXT("AddWeapon"), [&]() { Character->AddWeapon(Weapon); });
+	Check(TEXT("EquipWeapon"), [&]() { Character->EquipWeapon(Weapon); });
+	Check(TEXT("SetTargeting"), [&]() { Character->SetTargeting(true); });
+	Check(TEXT("SetRunning"), [&]() { Character->SetRunning(true, false); });
+	Check(TEXT("UseAmmo"), [&]() { Weapon->UseAmmo(); });
+	Check(TEXT("StartReload"), [&]() { Weapon->StartReload(); });
+	Check(TEXT("ReloadWeapon"), [&]() { Weapon->ReloadWeapon(); });
+	Check(TEXT("StopReload"), [&]() { Weapon->StopReload(); });
+	Check(TEXT("GiveAmmo"), [&]() { Weapon->UseAmmo(); Weapon->GiveAmmo(Weapon->GetMaxAmmo()); });
+	Check(TEXT("StartFire"), [&]() { Weapon->StartFire(); });
+	Check(TEXT("StopFire"), [&]() { Weapon->StopFire(); });
+	Character->Health = 1.f;
+	Check(TEXT("Health pickup"), [&]() { HealthPickup->NotifyActorBeginOverlap(Character); });
+	Check(TEXT("SetTeamNum"), [&]() { PlayerState->SetTeamNum(1); });
+	Check(TEXT("ScoreKill"), [&]() { PlayerState->ScoreKill(OtherPlayerState, 1); });
+	Check(TEXT("ScoreDeath"), [&]() { PlayerState->ScoreDeath(OtherPlayerState, 1); });
+	Check(TEXT("CopyProperties"), [&]() { PlayerState->CopyProperties(OtherPlayerState); });
+	Check(TEXT("Reset"), [&]() { PlayerState->Reset(); });
+	Check(TEXT("RemoveWeapon"), [&]() { Character->RemoveWeapon(Weapon); });
+
+	// Not a failure (some need a game mode or a remote connection), but changes to these went unchecked
+	TSet<FProperty*> AllProperties;
+	for (UObject* Object : Objects)
+	{
+		FSnapshot(Object).GetProperties(AllProperties);
+	}
+
+	for (FProperty* Property : AllProperties.Difference(Exercised))
+	{
+		AddInfo(FString::Printf(TEXT("%s::%s was not changed by any of the checked calls"), *Property->GetOwnerClass()->GetName(), *Property->GetName()));
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,184 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/PackageMapClient.h"
+#include "Tests/ShooterTestActors.h"
+#include "Tests/ShooterTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterSpreadStreamTest
+{
+	/** net GUIDs of dynamic actors are even and handed out in order, weapons of one match sit close together */
+	const uint32 WeaponKey = 0x1A4;
+	const uint32 OtherWeaponKey = 0x1A6;
+
+	/** sweeping the aim around like a player tracking a target */
+	FVector GetAimDir(int32 ShotIndex)
+	{
+		return FRotator(FMath::Sin(ShotIndex * 0.1f) * 20.f, ShotIndex * 3.f, 0.f).Vector();
+	}
+
+	/** spread of a rifle growing while the trigger is held, reset every 30 shots */
+	float GetReticleSpread(int32 ShotIndex)
+	{
+		return 5.f + (ShotIndex % 30) * 0.25f;
+	}
+
+	/** gives World a net driver that only has a GUID cache, what the spread stream is keyed from */
+	void AddGuidCacheNetDriver(UWorld* World)
+	{
+		UNetDriver* NetDriver = NewObject<UDemoNetDriver>(GetTransientPackage());
+		NetDriver->GuidCache = MakeShared<FNetGUIDCache>(NetDriver);
+		World->SetNetDriver(NetDriver);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterSpreadStreamTest, "ShooterGame.Net.SpreadStream", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FShooterSpreadStreamTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterSpreadStreamTest;
+
+	const int32 NumShots = 1000;
+
+	// the owning client fires and batches its shots, as FireWeapon and NotifyServerOfShot do
+	const FShooterSpreadStream ClientStream(WeaponKey);
+	TArray<FVector> ClientDirs;
+	TArray<FShooterBatchedShot> Shots;
+	for (int32 ShotIndex = 1; ShotIndex <= NumShots; ++ShotIndex)
+	{
+		const float ConeHalfAngle = FMath::DegreesToRadians(GetReticleSpread(ShotIndex) * 0.5f);
+		ClientDirs.Add(ClientStream.GetShotDir(ShotIndex, GetAimDir(ShotIndex), ConeHalfAngle));
+
+		FShooterBatchedShot& Shot = Shots.AddDefaulted_GetRef();
+		Shot.bFired = true;
+		Shot.Origin = FVector(100.f, 200.f, 150.f);
+		Shot.ShootDir = ClientDirs.Last();
+		Shot.ShotIndex = ShotIndex;
+		Shot.ReticleSpread = GetReticleSpread(ShotIndex);
+	}
+
+	// what the server gets: the index goes over the wire, the seed does not
+	FNetBitWriter Writer(NumShots * 256);
+	for (FShooterBatchedShot& Shot : Shots)
+	{
+		bool bSuccess = false;
+		Shot.NetSerialize(Writer, nullptr, bSuccess);
+	}
+
+	FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+	TArray<FShooterBatchedShot> ReceivedShots;
+	ReceivedShots.SetNum(NumShots);
+	for (FShooterBatchedShot& Shot : ReceivedShots)
+	{
+		bool bSuccess = false;
+		Shot.NetSerialize(Reader, nullptr, bSuccess);
+	}
+
+	TestTrue(TEXT("Batch deserialized"), !Reader.IsError() && Reader.AtEnd());
+	AddInfo(FString::Printf(TEXT("%.1f bits per batched miss"), (float)Writer.GetNumBits() / NumShots));
+
+	// the server and a simulated proxy derive the same cone on their own
+	const FShooterSpreadStream ServerStream(WeaponKey);
+	const FShooterSpreadStream OtherWeaponStream(OtherWeaponKey);
+	int32 NumMismatches = 0;
+	int32 NumSameAsOtherWeapon = 0;
+	int32 NumOutsideCone = 0;
+	FVector MeanOffset = FVector::ZeroVector;
+
+	for (int32 Idx = 0; Idx < NumShots; ++Idx)
+	{
+		const FShooterBatchedShot& Shot = ReceivedShots[Idx];
+		const FVector AimDir = GetAimDir(Shot.ShotIndex);
+		const float ConeHalfAngle = FMath::DegreesToRadians(Shot.ReticleSpread * 0.5f);
+		const FVector ServerDir = ServerStream.GetShotDir(Shot.ShotIndex, AimDir, ConeHalfAngle);
+
+		NumMismatches += (Shot.ShotIndex != Idx + 1 || !ServerDir.Equals(ClientDirs[Idx], 1e-4f) || !ServerDir.Equals(Shot.ShootDir, 1e-3f)) ? 1 : 0;
+		NumSameAsOtherWeapon += OtherWeaponStream.GetShotDir(Shot.ShotIndex, AimDir, ConeHalfAngle).Equals(ServerDir, 1e-4f) ? 1 : 0;
+		NumOutsideCone += FVector::DotProduct(ServerDir, AimDir) < FMath::Cos(ConeHalfAngle) - KINDA_SMALL_NUMBER ? 1 : 0;
+		MeanOffset += FQuat::FindBetweenNormals(AimDir, FVector::ForwardVector).RotateVector(ServerDir) - FVector::ForwardVector;
+	}
+
+	TestEqual(TEXT("Server regenerates every client shot"), NumMismatches, 0);
+	TestEqual(TEXT("Shots stay within the spread cone"), NumOutsideCone, 0);
+	TestTrue(TEXT("Other weapons have their own stream"), NumSameAsOtherWeapon < NumShots / 100);
+	TestTrue(TEXT("Spread is centered on the aim"), (MeanOffset / NumShots).Size() < 0.005f);
+
+	// neighbouring indices must not give correlated seeds
+	int32 NumRepeatedSeeds = 0;
+	for (int32 ShotIndex = 1; ShotIndex < NumShots; ++ShotIndex)
+	{
+		NumRepeatedSeeds += ServerStream.GetSeed(ShotIndex) == ServerStream.GetSeed(ShotIndex + 1) || ServerStream.GetSeed(ShotIndex) == OtherWeaponStream.GetSeed(ShotIndex) ? 1 : 0;
+	}
+	TestEqual(TEXT("Seeds differ between shots and weapons"), NumRepeatedSeeds, 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterSpreadStreamWeaponTest, "ShooterGame.Net.SpreadStream.Weapon", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FShooterSpreadStreamWeaponTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterSpreadStreamTest;
+
+	FShooterTestWorld ServerTestWorld(TEXT("ShooterSpreadStreamServer"));
+	FShooterTestWorld ClientTestWorld(TEXT("ShooterSpreadStreamClient"));
+	UWorld* ServerWorld = ServerTestWorld.Get();
+	UWorld* ClientWorld = ClientTestWorld.Get();
+	AddGuidCacheNetDriver(ServerWorld);
+	AddGuidCacheNetDriver(ClientWorld);
+
+	AShooterTestWeapon_Instant* ServerWeapon = ServerWorld->SpawnActor<AShooterTestWeapon_Instant>();
+	AShooterTestWeapon_Instant* ClientWeapon = ClientWorld->SpawnActor<AShooterTestWeapon_Instant>();
+	if (!TestTrue(TEXT("Spawned the weapons"), ServerWeapon && ClientWeapon))
+	{
+		return false;
+	}
+
+	// the server keys the stream the way FireWeapon does, assigning the weapon its net GUID
+	const FShooterSpreadStream ServerStream = ServerWeapon->GetTestSpreadStream();
+	const FNetworkGUID NetGUID = ServerWorld->GetNetDriver()->GuidCache->GetNetGUID(ServerWeapon);
+	TestTrue(TEXT("Server keyed the stream with the weapon's net GUID"), NetGUID.IsValid() && ServerStream.Key == NetGUID.Value);
+
+	// the weapon arrives on the client as a simulated proxy with the server's GUID, registered like the package map does
+	ClientWeapon->SetRole(ROLE_SimulatedProxy);
+	ClientWorld->GetNetDriver()->GuidCache->NetGUIDLookup.Add(ClientWeapon, NetGUID);
+	TestEqual(TEXT("Client stream has the server's key"), ClientWeapon->GetTestSpreadStream().Key, ServerStream.Key);
+
+	// regenerated shots take the newest update's aim and spread, steady here like a player holding the trigger on a target
+	const FVector AimDir = FRotator(10.f, 30.f, 0.f).Vector();
+	const float ReticleSpread = 6.f;
+	ServerWeapon->TestAim = AimDir;
+	ClientWeapon->TestAim = AimDir;
+
+	// updates the client gets: shots 4-6 and 9-19 only arrive with a later one, of the second gap only the newest 8 are regenerated
+	const int32 ReceivedShotIndices[] = { 1, 2, 3, 7, 8, 20, 21 };
+	const int32 ExpectedShotIndices[] = { 1, 2, 3, 4, 5, 6, 7, 8, 13, 14, 15, 16, 17, 18, 19, 20, 21 };
+
+	for (const int32 ShotIndex : ReceivedShotIndices)
+	{
+		FInstantHitInfo HitNotify;
+		HitNotify.Origin = FVector(0.f, 0.f, 100.f);
+		HitNotify.ReticleSpread = ReticleSpread;
+		HitNotify.ShotIndex = ShotIndex;
+		ClientWeapon->ReceiveHitNotify(HitNotify);
+	}
+
+	if (TestEqual(TEXT("Shots simulated"), ClientWeapon->SimulatedShots.Num(), (int32)UE_ARRAY_COUNT(ExpectedShotIndices)))
+	{
+		const float ConeHalfAngle = FMath::DegreesToRadians(ReticleSpread * 0.5f);
+		for (int32 Idx = 0; Idx < ClientWeapon->SimulatedShots.Num(); ++Idx)
+		{
+			const AShooterTestWeapon_Instant::FSimulatedShot& Shot = ClientWeapon->SimulatedShots[Idx];
+			TestEqual(TEXT("Simulated shot index"), Shot.ShotIndex, ExpectedShotIndices[Idx]);
+			TestTrue(FString::Printf(TEXT("Client regenerates the server's shot %d"), Shot.ShotIndex), Shot.ShootDir.Equals(ServerStream.GetShotDir(Shot.ShotIndex, AimDir, ConeHalfAngle), 1e-4f));
+		}
+	}
+
+	return true;
+}
+
+#endif
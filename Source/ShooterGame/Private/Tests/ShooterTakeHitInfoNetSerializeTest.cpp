@@ -0,0 +1,241 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "ShooterTypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterTakeHitInfoTest
+{
+	/**
+	 * Object references in place of a package map: every object costs the same packed index, so both encodings
+	 * pay the same for the references and the comparison is about everything else.
+	 */
+	struct FObjectTable
+	{
+		TArray<UObject*> Objects;
+
+		uint32 IndexOf(UObject* Object)
+		{
+			return Object ? (uint32)Objects.AddUnique(Object) + 1 : 0;
+		}
+
+		UObject* FromIndex(uint32 Index) const
+		{
+			return Objects.IsValidIndex((int32)Index - 1) ? Objects[Index - 1] : nullptr;
+		}
+	};
+
+	class FTestNetBitWriter : public FNetBitWriter
+	{
+	public:
+
+		FTestNetBitWriter(FObjectTable& InTable)
+			: FNetBitWriter(8192)
+			, Table(InTable)
+		{
+		}
+
+		virtual FArchive& operator<<(UObject*& Object) override
+		{
+			uint32 Index = Table.IndexOf(Object);
+			SerializeIntPacked(Index);
+			return *this;
+		}
+
+		virtual FArchive& operator<<(FWeakObjectPtr& Value) override
+		{
+			UObject* Object = Value.Get();
+			return *this << Object;
+		}
+
+	private:
+
+		FObjectTable& Table;
+	};
+
+	class FTestNetBitReader : public FNetBitReader
+	{
+	public:
+
+		FTestNetBitReader(const FObjectTable& InTable, FNetBitWriter& Writer)
+			: FNetBitReader(nullptr, Writer.GetData(), Writer.GetNumBits())
+			, Table(InTable)
+		{
+		}
+
+		virtual FArchive& operator<<(UObject*& Object) override
+		{
+			uint32 Index = 0;
+			SerializeIntPacked(Index);
+			Object = Table.FromIndex(Index);
+			return *this;
+		}
+
+		virtual FArchive& operator<<(FWeakObjectPtr& Value) override
+		{
+			UObject* Object = nullptr;
+			*this << Object;
+			Value = Object;
+			return *this;
+		}
+
+	private:
+
+		const FObjectTable& Table;
+	};
+
+	/**
+	 * What replicating FTakeHitInfo cost without a NetSerializer: the rep layout sends every property, structs flattened,
+	 * arrays as a 16 bit count followed by their elements. Property handles and headers are left out, they only add to this.
+	 */
+	void SerializeProperties(FArchive& Ar, const UStruct* Struct, void* Data)
+	{
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			if (!(It->PropertyFlags & CPF_RepSkip))
+			{
+				for (int32 Idx = 0; Idx < It->ArrayDim; ++Idx)
+				{
+					void* Value = It->ContainerPtrToValuePtr<void>(Data, Idx);
+
+					if (FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(*It))
+					{
+						UObject* Object = ObjectProperty->GetObjectPropertyValue(Value);
+						Ar << Object;
+					}
+					else if (FStructProperty* StructProperty = CastField<FStructProperty>(*It))
+					{
+						if (StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative)
+						{
+							StructProperty->NetSerializeItem(Ar, nullptr, Value);
+						}
+						else
+						{
+							SerializeProperties(Ar, StructProperty->Struct, Value);
+						}
+					}
+					else if (FArrayProperty* ArrayProperty = CastField<FArrayProperty>(*It))
+					{
+						FScriptArrayHelper Array(ArrayProperty, Value);
+						uint16 Num = (uint16)Array.Num();
+						Ar << Num;
+
+						for (int32 ElementIdx = 0; ElementIdx < Array.Num(); ++ElementIdx)
+						{
+							if (FStructProperty* InnerStruct = CastField<FStructProperty>(ArrayProperty->Inner))
+							{
+								if (InnerStruct->Struct->StructFlags & STRUCT_NetSerializeNative)
+								{
+									InnerStruct->NetSerializeItem(Ar, nullptr, Array.GetRawPtr(ElementIdx));
+								}
+								else
+								{
+									SerializeProperties(Ar, InnerStruct->Struct, Array.GetRawPtr(ElementIdx));
+								}
+							}
+							else
+							{
+								ArrayProperty->Inner->NetSerializeItem(Ar, nullptr, Array.GetRawPtr(ElementIdx));
+							}
+						}
+					}
+					else
+					{
+						It->NetSerializeItem(Ar, nullptr, Value);
+					}
+				}
+			}
+		}
+	}
+
+	FHitResult MakeHit(const FVector& ImpactPoint, const FVector& ImpactNormal)
+	{
+		FHitResult Hit(1.f);
+		Hit.bBlockingHit = true;
+		Hit.Location = ImpactPoint;
+		Hit.ImpactPoint = ImpactPoint;
+		Hit.Normal = ImpactNormal;
+		Hit.ImpactNormal = ImpactNormal;
+		Hit.TraceStart = ImpactPoint - ImpactNormal * 1000.f;
+		Hit.TraceEnd = ImpactPoint + ImpactNormal * 100.f;
+		Hit.BoneName = TEXT("spine_02");
+		return Hit;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterTakeHitInfoNetSerializeTest, "ShooterGame.Net.TakeHitInfoBandwidth", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FShooterTakeHitInfoNetSerializeTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterTakeHitInfoTest;
+
+	FDamageEvent GeneralEvent(UDamageType::StaticClass());
+
+	FPointDamageEvent PointEvent(30.f, MakeHit(FVector(1250.4f, -320.7f, 96.2f), FVector(-0.8f, 0.6f, 0.f)), FVector(0.8f, -0.6f, 0.f), UDamageType::StaticClass());
+
+	FRadialDamageEvent RadialEvent;
+	RadialEvent.DamageTypeClass = UDamageType::StaticClass();
+	RadialEvent.Origin = FVector(1000.f, -200.f, 50.f);
+	RadialEvent.Params = FRadialDamageParams(80.f, 10.f, 100.f, 300.f, 1.f);
+	RadialEvent.ComponentHits.Add(MakeHit(FVector(1080.f, -140.f, 90.f), FVector(-0.8f, -0.6f, 0.f)));
+	RadialEvent.ComponentHits.Add(MakeHit(FVector(1085.f, -150.f, 140.f), FVector(-0.8f, -0.6f, 0.f)));
+
+	const TPair<const TCHAR*, const FDamageEvent*> Events[] =
+	{
+		{ TEXT("General"), &GeneralEvent },
+		{ TEXT("Point"), &PointEvent },
+		{ TEXT("Radial"), &RadialEvent },
+	};
+
+	for (const TPair<const TCHAR*, const FDamageEvent*>& Event : Events)
+	{
+		FTakeHitInfo HitInfo;
+		HitInfo.ActualDamage = 27.35f;
+		HitInfo.bKilled = true;
+		HitInfo.SetDamageEvent(*Event.Value);
+		HitInfo.EnsureReplication();
+
+		FObjectTable Table;
+
+		FTestNetBitWriter Before(Table);
+		SerializeProperties(Before, FTakeHitInfo::StaticStruct(), &HitInfo);
+
+		FTestNetBitWriter After(Table);
+		bool bSuccess = false;
+		HitInfo.NetSerialize(After, nullptr, bSuccess);
+
+		AddInfo(FString::Printf(TEXT("%s hit: %lld bytes per hit before, %lld after"), Event.Key, (Before.GetNumBits() + 7) / 8, (After.GetNumBits() + 7) / 8));
+
+		TestTrue(FString::Printf(TEXT("%s hit serialized"), Event.Key), bSuccess && !After.IsError());
+		TestTrue(FString::Printf(TEXT("%s hit is smaller"), Event.Key), After.GetNumBits() < Before.GetNumBits());
+
+		// What the client gets has to play the hit the same way
+		FTakeHitInfo Received;
+		FTestNetBitReader Reader(Table, After);
+		bSuccess = false;
+		Received.NetSerialize(Reader, nullptr, bSuccess);
+
+		TestTrue(FString::Printf(TEXT("%s hit deserialized"), Event.Key), bSuccess && !Reader.IsError() && Reader.AtEnd());
+		TestEqual(FString::Printf(TEXT("%s hit damage"), Event.Key), Received.ActualDamage, HitInfo.ActualDamage, 0.05f);
+		TestTrue(FString::Printf(TEXT("%s hit kill"), Event.Key), Received.bKilled == HitInfo.bKilled);
+		TestTrue(FString::Printf(TEXT("%s hit damage type"), Event.Key), Received.DamageTypeClass == HitInfo.DamageTypeClass);
+		TestEqual(FString::Printf(TEXT("%s hit event"), Event.Key), Received.DamageEventClassID, HitInfo.DamageEventClassID);
+		TestTrue(FString::Printf(TEXT("%s hit event damage type"), Event.Key), Received.GetDamageEvent().DamageTypeClass == HitInfo.GetDamageEvent().DamageTypeClass);
+
+		if (Event.Value != &GeneralEvent)
+		{
+			FHitResult SentHit, ReceivedHit;
+			FVector SentDir, ReceivedDir;
+			HitInfo.GetDamageEvent().GetBestHitInfo(nullptr, nullptr, SentHit, SentDir);
+			Received.GetDamageEvent().GetBestHitInfo(nullptr, nullptr, ReceivedHit, ReceivedDir);
+
+			TestTrue(FString::Printf(TEXT("%s hit impulse direction"), Event.Key), ReceivedDir.Equals(SentDir, 0.01f));
+		}
+	}
+
+	return true;
+}
+
+#endif
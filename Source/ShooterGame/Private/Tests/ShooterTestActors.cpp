@@ -0,0 +1,34 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Tests/ShooterTestActors.h"
+
+UShooterTestCharacterMovement::UShooterTestCharacterMovement(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	WallMaxDistance = 20.0f;
+	WallRunCornerVariance = 0.7f;
+	WallRunSpeed = 1000.0f;
+	WallRunGravity = 0.0f;
+	WallJumpForce = 500.0f;
+}
+
+AShooterTestCharacter::AShooterTestCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UShooterTestCharacterMovement>(ACharacter::CharacterMovementComponentName))
+{
+}
+
+void AShooterTestWeapon_Instant::ReceiveHitNotify(const FInstantHitInfo& NewHitNotify)
+{
+	HitNotify = NewHitNotify;
+	OnRep_HitNotify();
+}
+
+void AShooterTestWeapon_Instant::SimulateInstantHit(const FVector& Origin, int32 ShotIndex, float ReticleSpread)
+{
+	FSimulatedShot& Shot = SimulatedShots.AddDefaulted_GetRef();
+	Shot.ShotIndex = ShotIndex;
+	Shot.ShootDir = GetSimulatedShotDir(ShotIndex, ReticleSpread);
+
+	Super::SimulateInstantHit(Origin, ShotIndex, ReticleSpread);
+}
@@ -0,0 +1,102 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#include "Tests/ShooterTestControllerServerMoveRate.h"
+#include "ShooterGame.h"
+#include "Player/ShooterCharacterMovement.h"
+
+void UShooterTestControllerServerMoveRate::OnInit()
+{
+	Super::OnInit();
+
+	bMovePawn              = !FParse::Param(FCommandLine::Get(), TEXT("ServerMoveIdle"));
+	bWasInGame             = false;
+	TimeInGame             = 0.0f;
+	TimeSampled            = 0.0f;
+	NumFramesSampled       = 0;
+	NumServerMovesSampled  = 0;
+	LastNumServerMovesSent = 0;
+
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ServerMoveSampleTime="), SampleTime))
+	{
+		SampleTime = 30.0f;
+	}
+
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ServerMoveWarmupTime="), WarmupTime))
+	{
+		WarmupTime = 5.0f;
+	}
+}
+
+void UShooterTestControllerServerMoveRate::OnPostMapChange(UWorld* World)
+{
+	// no match cycling, the test ends once it has sampled
+	if (IsInGame())
+	{
+		bWasInGame = true;
+		TimeInGame = 0.0f;
+	}
+	else if (bWasInGame)
+	{
+		UE_LOG(LogGauntlet, Error, TEXT("Failed!  Left the game after sampling %.1fs of %.1fs!"), TimeSampled, SampleTime);
+		EndTest(-1);
+	}
+}
+
+void UShooterTestControllerServerMoveRate::OnTick(float TimeDelta)
+{
+	Super::OnTick(TimeDelta);
+
+	if (!IsInGame())
+	{
+		if (GetTimeInCurrentState() > 300)
+		{
+			UE_LOG(LogGauntlet, Error, TEXT("Failed!  Not in game after 300 secs!"));
+			EndTest(-1);
+		}
+		return;
+	}
+
+	ULocalPlayer* LocalPlayer    = GetFirstLocalPlayer();
+	APlayerController* PC        = LocalPlayer ? LocalPlayer->PlayerController : nullptr;
+	ACharacter* Pawn             = PC ? Cast<ACharacter>(PC->GetPawn()) : nullptr;
+	UShooterCharacterMovement* Movement = Pawn ? Cast<UShooterCharacterMovement>(Pawn->GetCharacterMovement()) : nullptr;
+
+	// not spawned yet, or dead
+	if (Movement == nullptr)
+	{
+		return;
+	}
+
+	if (Movement != SampledMovement.Get())
+	{
+		SampledMovement = Movement;
+		LastNumServerMovesSent = Movement->GetNumServerMovesSent();
+	}
+
+	TimeInGame += TimeDelta;
+	if (TimeInGame < WarmupTime)
+	{
+		LastNumServerMovesSent = Movement->GetNumServerMovesSent();
+		return;
+	}
+
+	if (bMovePawn)
+	{
+		// run straight, turning around every two seconds
+		const float Direction = FMath::Fmod(TimeSampled, 4.0f) < 2.0f ? 1.0f : -1.0f;
+		Pawn->AddMovementInput(Pawn->GetActorForwardVector(), Direction);
+	}
+
+	NumServerMovesSampled += Movement->GetNumServerMovesSent() - LastNumServerMovesSent;
+	LastNumServerMovesSent = Movement->GetNumServerMovesSent();
+
+	TimeSampled += TimeDelta;
+	++NumFramesSampled;
+
+	if (TimeSampled >= SampleTime)
+	{
+		UE_LOG(LogGauntlet, Display, TEXT("ServerMove rate: %.1f RPCs per second at %.1f fps (%d RPCs over %d frames in %.1fs, %s)"),
+			NumServerMovesSampled / TimeSampled, NumFramesSampled / TimeSampled, NumServerMovesSampled, NumFramesSampled, TimeSampled,
+			bMovePawn ? TEXT("running") : TEXT("idle"));
+		EndTest(0);
+	}
+}
@@ -0,0 +1,24 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Tests/ShooterTestWorld.h"
+
+FShooterTestWorld::FShooterTestWorld(const TCHAR* Name)
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, Name);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	const FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+}
+
+FShooterTestWorld::~FShooterTestWorld()
+{
+	// tests may hand the world a net driver of their own, it isn't registered with the engine
+	World->SetNetDriver(nullptr);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Misc/AutomationTest.h"
+#include "Components/BoxComponent.h"
+#include "Tests/ShooterTestActors.h"
+#include "Tests/ShooterTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterWallRunTest
+{
+	const int32 NumFrames = 120;
+	const float DeltaTime = 1.f / 60.f;
+
+	/** the wall's face is the plane X = 0, it ends at Y = WallEndY */
+	const float WallEndY = 500.f;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterWallRunEndTest, "ShooterGame.Net.WallRun.RunOffEnd", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FShooterWallRunEndTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterWallRunTest;
+
+	FShooterTestWorld TestWorld(TEXT("ShooterWallRunTest"));
+	UWorld* World = TestWorld.Get();
+
+	// static, so the wall contact cache is used along it
+	AActor* Wall = World->SpawnActor<AActor>();
+	UBoxComponent* WallBox = NewObject<UBoxComponent>(Wall);
+	WallBox->SetMobility(EComponentMobility::Static);
+	WallBox->SetBoxExtent(FVector(100.f, WallEndY, 500.f));
+	WallBox->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	WallBox->SetRelativeLocation(FVector(-100.f, 0.f, 0.f));
+	Wall->SetRootComponent(WallBox);
+	WallBox->RegisterComponent();
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AShooterTestCharacter* Character = World->SpawnActor<AShooterTestCharacter>(AShooterTestCharacter::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnInfo);
+	UShooterCharacterMovement* Movement = Character ? Cast<UShooterCharacterMovement>(Character->GetCharacterMovement()) : nullptr;
+	if (!TestNotNull(TEXT("Spawned the character"), Movement))
+	{
+		return false;
+	}
+
+	// next to the wall, running along it towards its end, holding jump the way the server gets it from the move flags
+	const float CapsuleRadius = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	Character->SetActorLocation(FVector(CapsuleRadius + 5.f, -300.f, 0.f));
+	Movement->bRunPhysicsWithNoController = true;
+	Movement->UpdateFromCompressedFlags(FSavedMove_Character::FLAG_Custom_1);
+	Movement->Velocity = FVector(0.f, 1000.f, 0.f);
+	Movement->StartWallRun(FVector(-1.f, 0.f, 0.f));
+
+	const int32 NumTracesAtStart = Movement->GetNumWallTraces();
+	int32 NumTracesBeforeStop = 0;
+	int32 NumWallRunFrames = 0;
+
+	float StopY = -1.f;
+	for (int32 Frame = 0; Frame < NumFrames && StopY < 0.f; ++Frame)
+	{
+		const int32 NumTracesBeforeFrame = Movement->GetNumWallTraces();
+
+		World->Tick(LEVELTICK_All, DeltaTime);
+
+		if (Movement->MovementMode != MOVE_Custom || Movement->CustomMovementMode != SHOOTERMOVE_WallRunning)
+		{
+			StopY = Character->GetActorLocation().Y;
+			NumTracesBeforeStop = NumTracesBeforeFrame;
+		}
+		else
+		{
+			++NumWallRunFrames;
+		}
+	}
+
+	// the wall is traced from the capsule's center, so the run ends within a frame of the center passing the end
+	const float FrameMove = 1000.f * DeltaTime;
+	TestTrue(TEXT("Stopped wall running"), StopY >= 0.f);
+	TestTrue(FString::Printf(TEXT("Wall ran to the end of the wall (stopped at Y %.1f)"), StopY), StopY >= WallEndY - CapsuleRadius);
+	TestTrue(FString::Printf(TEXT("Stopped at the end of the wall (stopped at Y %.1f, wall ends at %.1f)"), StopY, WallEndY), StopY <= WallEndY + FrameMove + 1.f);
+
+	// every frame finds the wall, without the cache each of them would trace the world
+	const int32 NumTracesAlongWall = NumTracesBeforeStop - NumTracesAtStart;
+	TestTrue(FString::Printf(TEXT("Wall contact cache used along the wall (%d world traces in %d frames)"), NumTracesAlongWall, NumWallRunFrames), NumTracesAlongWall < NumWallRunFrames / 2);
+	TestTrue(TEXT("Cached steps probed the wall"), Movement->GetNumWallProbes() > 0);
+	TestTrue(TEXT("Traced the world again at the end of the wall"), Movement->GetNumWallTraces() > NumTracesBeforeStop);
+
+	return true;
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include "Weapons/ShooterProjectile.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Effects/ShooterExplosionEffect.h"
+#include "Effects/ShooterEffectsSubsystem.h"
+#include "Weapons/ShooterProjectilePoolSubsystem.h"
 
 AShooterProjectile::AShooterProjectile(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -43,6 +45,13 @@ void AShooterProjectile::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 	MovementComp->OnProjectileStop.AddDynamic(this, &AShooterProjectile::OnImpact);
+
+	InitProjectile();
+}
+
+void AShooterProjectile::InitProjectile()
+{
+	CollisionComp->MoveIgnoreActors.Reset();
 	CollisionComp->MoveIgnoreActors.Add(GetInstigator());
 
 	AShooterWeapon_Projectile* OwnerWeapon = Cast<AShooterWeapon_Projectile>(GetOwner());
@@ -65,10 +74,13 @@ void AShooterProjectile::InitVelocity(FVector& ShootDirection)
 
 void AShooterProjectile::OnImpact(const FHitResult& HitResult)
 {
-	if (GetLocalRole() == ROLE_Authority && !bExploded)
+	if (GetLocalRole() == ROLE_Authority && !bExploded && !bVisualOnly)
 	{
 		Explode(HitResult);
 		DisableAndDestroy();
+
+		// projectiles replicate at a reduced rate, don't let the explosion wait for the next slot
+		ForceNetUpdate();
 	}
 }
 
@@ -82,7 +94,7 @@ void AShooterProjectile::Explode(const FHitResult& Impact)
 	// effects and damage origin shouldn't be placed inside mesh at impact point
 	const FVector NudgedImpactLocation = Impact.ImpactPoint + Impact.ImpactNormal * 10.0f;
 
-	if (WeaponConfig.ExplosionDamage > 0 && WeaponConfig.ExplosionRadius > 0 && WeaponConfig.DamageType)
+	if (WeaponConfig.ExplosionDamage > 0 && WeaponConfig.ExplosionRadius > 0 && WeaponConfig.DamageType && !bVisualOnly)
 	{
 		UGameplayStatics::ApplyRadialDamage(this, WeaponConfig.ExplosionDamage, NudgedImpactLocation, WeaponConfig.ExplosionRadius, WeaponConfig.DamageType, TArray<AActor*>(), this, MyController.Get());
 	}
@@ -90,11 +102,9 @@ void AShooterProjectile::Explode(const FHitResult& Impact)
 	if (ExplosionTemplate)
 	{
 		FTransform const SpawnTransform(Impact.ImpactNormal.Rotation(), NudgedImpactLocation);
-		AShooterExplosionEffect* const EffectActor = GetWorld()->SpawnActorDeferred<AShooterExplosionEffect>(ExplosionTemplate, SpawnTransform);
-		if (EffectActor)
+		if (UShooterEffectsSubsystem* Effects = GetWorld()->GetSubsystem<UShooterEffectsSubsystem>())
 		{
-			EffectActor->SurfaceHit = Impact;
-			UGameplayStatics::FinishSpawningActor(EffectActor, SpawnTransform);
+			Effects->SpawnExplosionEffect(ExplosionTemplate, SpawnTransform, Impact);
 		}
 	}
 
@@ -115,9 +125,147 @@ void AShooterProjectile::DisableAndDestroy()
 	SetLifeSpan( 2.0f );
 }
 
+void AShooterProjectile::LifeSpanExpired()
+{
+	UShooterProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UShooterProjectilePoolSubsystem>();
+	if (GetLocalRole() == ROLE_Authority && !bVisualOnly && Pool && Pool->ReleaseProjectile(this))
+	{
+		return;
+	}
+
+	Super::LifeSpanExpired();
+}
+
+void AShooterProjectile::InitVisual()
+{
+	bVisualOnly = true;
+	SetReplicates(false);
+}
+
+void AShooterProjectile::ExplodeVisual(const FVector& ImpactPoint, const FVector& ImpactNormal)
+{
+	if (bExploded)
+	{
+		return;
+	}
+
+	FHitResult Impact(GetActorLocation(), ImpactPoint);
+	Impact.bBlockingHit = true;
+	Impact.Location = ImpactPoint;
+	Impact.ImpactPoint = ImpactPoint;
+	Impact.Normal = ImpactNormal;
+	Impact.ImpactNormal = ImpactNormal;
+
+	SetActorLocation(ImpactPoint);
+	Explode(Impact);
+	DisableAndDestroy();
+}
+
+float AShooterProjectile::GetInitialSpeed() const
+{
+	return MovementComp->InitialSpeed;
+}
+
+float AShooterProjectile::GetCollisionRadius() const
+{
+	return CollisionComp->GetUnscaledSphereRadius();
+}
+
+void AShooterProjectile::EnterPool()
+{
+	bPooled = true;
+	bExploded = false;
+	ApplyPooledState();
+
+	SetLifeSpan(0.f);
+	SetOwner(NULL);
+	SetInstigator(NULL);
+	MyController = NULL;
+
+	// the channel closes once clients have the pooled state, they keep the actor until it is woken up again
+	ForceNetUpdate();
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AShooterProjectile::LeavePool(const FTransform& SpawnTransform, const FVector& ShootDirection, AActor* NewOwner, APawn* NewInstigator)
+{
+	SetActorTransform(SpawnTransform, false, NULL, ETeleportType::ResetPhysics);
+	SetOwner(NewOwner);
+	SetInstigator(NewInstigator);
+
+	bPooled = false;
+	ApplyPooledState();
+	InitProjectile();
+
+	// what the movement component does with the velocity of a newly spawned projectile
+	FVector Direction = ShootDirection;
+	InitVelocity(Direction);
+	if (MovementComp->bInitialVelocityInLocalSpace)
+	{
+		MovementComp->SetVelocityInLocalSpace(MovementComp->Velocity);
+	}
+	if (MovementComp->bRotationFollowsVelocity)
+	{
+		SetActorRotation(MovementComp->Velocity.Rotation());
+	}
+	MovementComp->UpdateComponentVelocity();
+
+	// reopens the channels on the actors clients kept
+	SetNetDormancy(DORM_Awake);
+	ForceNetUpdate();
+}
+
+void AShooterProjectile::ApplyPooledState()
+{
+	SetActorHiddenInGame(bPooled);
+	SetActorEnableCollision(!bPooled);
+	SetActorTickEnabled(!bPooled);
+
+	// same components running as right after spawning
+	for (UActorComponent* Component : GetComponents())
+	{
+		if (bPooled)
+		{
+			Component->Deactivate();
+		}
+		else if (Component->bAutoActivate)
+		{
+			Component->Activate(true);
+		}
+	}
+
+	if (bPooled)
+	{
+		MovementComp->StopMovementImmediately();
+		ParticleComp->KillParticlesForced();
+	}
+	else
+	{
+		// the movement component lets go of the collision when it stops on impact
+		MovementComp->SetUpdatedComponent(CollisionComp);
+		MovementComp->Activate(true);
+	}
+}
+
+void AShooterProjectile::OnRep_Pooled()
+{
+	ApplyPooledState();
+
+	if (!bPooled)
+	{
+		InitProjectile();
+	}
+}
+
 ///CODE_SNIPPET_START: AActor::GetActorLocation AActor::GetActorRotation
 void AShooterProjectile::OnRep_Exploded()
 {
+	// reset when the projectile went back to the pool
+	if (!bExploded)
+	{
+		return;
+	}
+
 	FVector ProjDirection = GetActorForwardVector();
 
 	const FVector StartTrace = GetActorLocation() - ProjDirection * 200;
@@ -148,4 +296,5 @@ void AShooterProjectile::GetLifetimeReplicatedProps( TArray< FLifetimeProperty >
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 	
 	DOREPLIFETIME( AShooterProjectile, bExploded );
+	DOREPLIFETIME( AShooterProjectile, bPooled );
 }
\ No newline at end of file
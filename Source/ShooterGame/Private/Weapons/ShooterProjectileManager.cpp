@@ -0,0 +1,407 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Weapons/ShooterProjectileManager.h"
+#include "Weapons/ShooterProjectile.h"
+
+static int32 ProjectileManagerEnabled = 0;
+FAutoConsoleVariableRef CVarProjectileManager(
+	TEXT("p.ProjectileManager"),
+	ProjectileManagerEnabled,
+	TEXT("Simulate projectiles in AShooterProjectileManager instead of as one replicated actor each.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+/** how long an exploded projectile stays in the replicated array, for clients to get the explosion */
+static const float ExplodedProjectileLifetime = 1.0f;
+
+/** clients older than this when they hear about a projectile don't show its flight, only the explosion */
+static const float MaxVisualCatchUp = 0.5f;
+
+DECLARE_CYCLE_STAT(TEXT("ProjectileManager Step"), STAT_ShooterProjectileManager_Step, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("ProjectileManager Projectiles"), STAT_ShooterProjectileManager_Projectiles, STATGROUP_Game);
+
+//////////////////////////////////////////////////////////////////////////
+// FShooterProjectileSimulation
+
+int32 FShooterProjectileSimulation::Add(const FVector& Location, const FVector& Velocity, float Radius, float TimeLeft, APawn* Instigator, AController* Owner, int32 ConfigIndex)
+{
+	const int32 Id = ++LastId;
+
+	Ids.Add(Id);
+	Locations.Add(Location);
+	Velocities.Add(Velocity);
+	Radii.Add(Radius);
+	TimesLeft.Add(TimeLeft);
+	ConfigIndices.Add(ConfigIndex);
+	Instigators.Add(Instigator);
+	Owners.Add(Owner);
+
+	return Id;
+}
+
+void FShooterProjectileSimulation::Step(UWorld* World, float DeltaTime, TArray<FImpact>& OutImpacts, TArray<int32>& OutExpiredIds)
+{
+	// same channel as the projectile actor's collision sphere, so triggers and overlap only shapes are flown through
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterProjectileManager), true);
+
+	for (int32 Idx = Ids.Num() - 1; Idx >= 0; --Idx)
+	{
+		const FVector Start = Locations[Idx];
+		const FVector End = Start + Velocities[Idx] * DeltaTime;
+
+		QueryParams.ClearIgnoredActors();
+		QueryParams.AddIgnoredActor(Instigators[Idx].Get());
+
+		FHitResult Hit;
+		if (World->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, COLLISION_PROJECTILE, FCollisionShape::MakeSphere(Radii[Idx]), QueryParams))
+		{
+			FImpact& Impact = OutImpacts.AddDefaulted_GetRef();
+			Impact.Id = Ids[Idx];
+			Impact.ConfigIndex = ConfigIndices[Idx];
+			Impact.Owner = Owners[Idx];
+			Impact.Hit = Hit;
+
+			RemoveAtSwap(Idx);
+			continue;
+		}
+
+		Locations[Idx] = End;
+		TimesLeft[Idx] -= DeltaTime;
+
+		if (TimesLeft[Idx] <= 0.f)
+		{
+			OutExpiredIds.Add(Ids[Idx]);
+			RemoveAtSwap(Idx);
+		}
+	}
+}
+
+void FShooterProjectileSimulation::Reset()
+{
+	Ids.Reset();
+	Locations.Reset();
+	Velocities.Reset();
+	Radii.Reset();
+	TimesLeft.Reset();
+	ConfigIndices.Reset();
+	Instigators.Reset();
+	Owners.Reset();
+}
+
+void FShooterProjectileSimulation::RemoveAtSwap(int32 Index)
+{
+	Ids.RemoveAtSwap(Index, 1, false);
+	Locations.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	Radii.RemoveAtSwap(Index, 1, false);
+	TimesLeft.RemoveAtSwap(Index, 1, false);
+	ConfigIndices.RemoveAtSwap(Index, 1, false);
+	Instigators.RemoveAtSwap(Index, 1, false);
+	Owners.RemoveAtSwap(Index, 1, false);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FShooterManagedProjectile
+
+void FShooterManagedProjectile::PostReplicatedAdd(const FShooterManagedProjectiles& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnProjectileReceived(*this);
+	}
+}
+
+void FShooterManagedProjectile::PostReplicatedChange(const FShooterManagedProjectiles& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnProjectileReceived(*this);
+	}
+}
+
+void FShooterManagedProjectile::PreReplicatedRemove(const FShooterManagedProjectiles& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnProjectileRemoved(*this);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AShooterProjectileManager
+
+AShooterProjectileManager::AShooterProjectileManager(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	// changes are pushed out with ForceNetUpdate
+	NetUpdateFrequency = 10.f;
+
+	Projectiles.Owner = this;
+}
+
+TMap<FObjectKey, TWeakObjectPtr<AShooterProjectileManager>> AShooterProjectileManager::WorldManagers;
+
+AShooterProjectileManager* AShooterProjectileManager::Get(UWorld* World)
+{
+	if (const TWeakObjectPtr<AShooterProjectileManager>* Cached = WorldManagers.Find(World))
+	{
+		AShooterProjectileManager* Manager = Cached->Get();
+		if (Manager && !Manager->IsPendingKillPending())
+		{
+			return Manager;
+		}
+	}
+
+	// not begun play yet
+	for (TActorIterator<AShooterProjectileManager> It(World); It; ++It)
+	{
+		if (!It->IsPendingKillPending())
+		{
+			return *It;
+		}
+	}
+
+	if (World->GetNetMode() == NM_Client)
+	{
+		return NULL;
+	}
+
+	FActorSpawnParameters SpawnInfo;
+	SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnInfo.ObjectFlags |= RF_Transient;
+	return World->SpawnActor<AShooterProjectileManager>(SpawnInfo);
+}
+
+bool AShooterProjectileManager::IsEnabled()
+{
+	return ProjectileManagerEnabled != 0;
+}
+
+void AShooterProjectileManager::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	DOREPLIFETIME( AShooterProjectileManager, Projectiles );
+}
+
+void AShooterProjectileManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	WorldManagers.Add(GetWorld(), this);
+}
+
+void AShooterProjectileManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const FObjectKey WorldKey(GetWorld());
+	if (const TWeakObjectPtr<AShooterProjectileManager>* Cached = WorldManagers.Find(WorldKey))
+	{
+		if (*Cached == this)
+		{
+			WorldManagers.Remove(WorldKey);
+		}
+	}
+
+	for (FShooterManagedProjectile& Projectile : Projectiles.Items)
+	{
+		OnProjectileRemoved(Projectile);
+	}
+
+	DEC_DWORD_STAT_BY(STAT_ShooterProjectileManager_Projectiles, Simulation.Num());
+	Simulation.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterProjectileManager::SpawnProjectile(const FProjectileWeaponData& Config, const FVector& Origin, const FVector& ShootDir, APawn* Instigator)
+{
+	const AShooterProjectile* ProjectileCDO = Config.ProjectileClass ? Config.ProjectileClass->GetDefaultObject<AShooterProjectile>() : NULL;
+	if (ProjectileCDO == NULL)
+	{
+		return;
+	}
+
+	const int32 Id = Simulation.Add(Origin, ShootDir * ProjectileCDO->GetInitialSpeed(), ProjectileCDO->GetCollisionRadius(), Config.ProjectileLife,
+		Instigator, Instigator ? Instigator->GetController() : NULL, FindOrAddConfig(Config));
+	INC_DWORD_STAT(STAT_ShooterProjectileManager_Projectiles);
+
+	FShooterManagedProjectile& Projectile = Projectiles.Items.AddDefaulted_GetRef();
+	Projectile.Id = Id;
+	Projectile.ProjectileClass = Config.ProjectileClass;
+	Projectile.Instigator = Instigator;
+	Projectile.Origin = Origin;
+	Projectile.Direction = ShootDir;
+	Projectile.SpawnTime = GetWorld()->GetTimeSeconds();
+	Projectiles.MarkItemDirty(Projectile);
+
+	if (ShouldShowVisuals())
+	{
+		SpawnVisual(Projectile);
+	}
+
+	// don't wait for the next update to show the shot
+	ForceNetUpdate();
+}
+
+void AShooterProjectileManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	TArray<FShooterProjectileSimulation::FImpact> Impacts;
+	TArray<int32> ExpiredIds;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ShooterProjectileManager_Step);
+		Simulation.Step(GetWorld(), DeltaSeconds, Impacts, ExpiredIds);
+	}
+
+	DEC_DWORD_STAT_BY(STAT_ShooterProjectileManager_Projectiles, Impacts.Num() + ExpiredIds.Num());
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	bool bChanged = false;
+
+	for (const FShooterProjectileSimulation::FImpact& Impact : Impacts)
+	{
+		const FProjectileWeaponData& Config = Configs[Impact.ConfigIndex];
+
+		// effects and damage origin shouldn't be placed inside mesh at impact point
+		const FVector NudgedImpactLocation = Impact.Hit.ImpactPoint + Impact.Hit.ImpactNormal * 10.0f;
+
+		if (Config.ExplosionDamage > 0 && Config.ExplosionRadius > 0 && Config.DamageType)
+		{
+			UGameplayStatics::ApplyRadialDamage(this, Config.ExplosionDamage, NudgedImpactLocation, Config.ExplosionRadius, Config.DamageType, TArray<AActor*>(), this, Impact.Owner.Get());
+		}
+
+		FShooterManagedProjectile* Projectile = Projectiles.Items.FindByPredicate([&Impact](const FShooterManagedProjectile& Item) { return Item.Id == Impact.Id; });
+		if (Projectile)
+		{
+			Projectile->bExploded = true;
+			Projectile->ImpactPoint = Impact.Hit.ImpactPoint;
+			Projectile->ImpactNormal = Impact.Hit.ImpactNormal;
+			Projectile->RemoveTime = Now + ExplodedProjectileLifetime;
+			Projectiles.MarkItemDirty(*Projectile);
+			bChanged = true;
+
+			if (ShouldShowVisuals())
+			{
+				ExplodeVisual(*Projectile);
+			}
+		}
+	}
+
+	for (int32 ExpiredId : ExpiredIds)
+	{
+		FShooterManagedProjectile* Projectile = Projectiles.Items.FindByPredicate([ExpiredId](const FShooterManagedProjectile& Item) { return Item.Id == ExpiredId; });
+		if (Projectile)
+		{
+			Projectile->RemoveTime = Now;
+		}
+	}
+
+	for (int32 Idx = Projectiles.Items.Num() - 1; Idx >= 0; --Idx)
+	{
+		FShooterManagedProjectile& Projectile = Projectiles.Items[Idx];
+		if (Projectile.RemoveTime > 0.f && Projectile.RemoveTime <= Now)
+		{
+			OnProjectileRemoved(Projectile);
+			Projectiles.Items.RemoveAtSwap(Idx, 1, false);
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		Projectiles.MarkArrayDirty();
+		ForceNetUpdate();
+	}
+}
+
+int32 AShooterProjectileManager::FindOrAddConfig(const FProjectileWeaponData& Config)
+{
+	const int32 ConfigIndex = Configs.IndexOfByPredicate([&Config](const FProjectileWeaponData& Other)
+	{
+		return Other.ProjectileClass == Config.ProjectileClass && Other.ProjectileLife == Config.ProjectileLife && Other.ExplosionDamage == Config.ExplosionDamage
+			&& Other.ExplosionRadius == Config.ExplosionRadius && Other.DamageType == Config.DamageType;
+	});
+
+	return ConfigIndex != INDEX_NONE ? ConfigIndex : Configs.Add(Config);
+}
+
+bool AShooterProjectileManager::ShouldShowVisuals() const
+{
+	return GetNetMode() != NM_DedicatedServer;
+}
+
+void AShooterProjectileManager::OnProjectileReceived(FShooterManagedProjectile& Projectile)
+{
+	if (!Projectile.Visual.IsValid() && !Projectile.bExploded)
+	{
+		SpawnVisual(Projectile);
+	}
+
+	if (Projectile.bExploded)
+	{
+		ExplodeVisual(Projectile);
+	}
+}
+
+void AShooterProjectileManager::OnProjectileRemoved(FShooterManagedProjectile& Projectile)
+{
+	// exploded ones go away on their own once the explosion played
+	AShooterProjectile* Visual = Projectile.Visual.Get();
+	if (Visual && !Projectile.bExploded)
+	{
+		Visual->Destroy();
+	}
+
+	Projectile.Visual = NULL;
+}
+
+void AShooterProjectileManager::SpawnVisual(FShooterManagedProjectile& Projectile)
+{
+	const AShooterProjectile* ProjectileCDO = Projectile.ProjectileClass ? Projectile.ProjectileClass->GetDefaultObject<AShooterProjectile>() : NULL;
+	if (ProjectileCDO == NULL)
+	{
+		return;
+	}
+
+	// it has been flying for half the ping already
+	AGameStateBase* const GameState = GetWorld()->GetGameState();
+	const float Age = GameState ? GameState->GetServerWorldTimeSeconds() - Projectile.SpawnTime : 0.f;
+	if (Age > MaxVisualCatchUp)
+	{
+		return;
+	}
+
+	const FVector Location = Projectile.Origin + Projectile.Direction * ProjectileCDO->GetInitialSpeed() * FMath::Max(Age, 0.f);
+	const FTransform SpawnTM(Projectile.Direction.Rotation(), Location);
+
+	AShooterProjectile* Visual = GetWorld()->SpawnActorDeferred<AShooterProjectile>(Projectile.ProjectileClass, SpawnTM, NULL, Projectile.Instigator, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Visual)
+	{
+		FVector Direction = Projectile.Direction;
+		Visual->InitVisual();
+		Visual->InitVelocity(Direction);
+
+		UGameplayStatics::FinishSpawningActor(Visual, SpawnTM);
+		Projectile.Visual = Visual;
+	}
+}
+
+void AShooterProjectileManager::ExplodeVisual(FShooterManagedProjectile& Projectile)
+{
+	AShooterProjectile* Visual = Projectile.Visual.Get();
+	if (Visual)
+	{
+		Visual->ExplodeVisual(Projectile.ImpactPoint, Projectile.ImpactNormal);
+	}
+}
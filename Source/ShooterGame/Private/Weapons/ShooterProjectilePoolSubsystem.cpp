@@ -0,0 +1,165 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShooterGame.h"
+#include "Weapons/ShooterProjectilePoolSubsystem.h"
+#include "Weapons/ShooterProjectile.h"
+
+static int32 ProjectilePooling = 1;
+FAutoConsoleVariableRef CVarProjectilePooling(
+	TEXT("p.ProjectilePooling"),
+	ProjectilePooling,
+	TEXT("Reuse projectile actors instead of spawning and destroying one per shot.\n")
+	TEXT("0: Disable, 1: Enable"),
+	ECVF_Default);
+
+static int32 ProjectilePoolSize = 16;
+FAutoConsoleVariableRef CVarProjectilePoolSize(
+	TEXT("p.ProjectilePoolSize"),
+	ProjectilePoolSize,
+	TEXT("Most free projectiles kept per class, the ones released past this are destroyed."),
+	ECVF_Default);
+
+static int32 ProjectilePoolPrewarm = 4;
+FAutoConsoleVariableRef CVarProjectilePoolPrewarm(
+	TEXT("p.ProjectilePoolPrewarm"),
+	ProjectilePoolPrewarm,
+	TEXT("Free projectiles spawned up front when a weapon firing them enters the game."),
+	ECVF_Default);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Spawned"), STAT_ShooterProjectilesSpawned, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Reused"), STAT_ShooterProjectilesReused, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Pooled"), STAT_ShooterProjectilesPooled, STATGROUP_Game);
+
+void UShooterProjectilePoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UShooterProjectilePoolSubsystem::OnPreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UShooterProjectilePoolSubsystem::OnPostGarbageCollect);
+}
+
+void UShooterProjectilePoolSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	if (NumSpawned > 0)
+	{
+		UE_LOG(LogShooterWeapon, Log, TEXT("Projectile pool (p.ProjectilePooling %d): %d projectiles spawned, %d reused, %d destroyed. %d garbage collections took %.1fms"),
+			ProjectilePooling, NumSpawned, NumReused, NumDestroyed, NumGarbageCollections, GarbageCollectSeconds * 1000.0);
+	}
+
+	for (const TPair<FObjectKey, TArray<TWeakObjectPtr<AShooterProjectile>>>& Pool : FreeProjectiles)
+	{
+		DEC_DWORD_STAT_BY(STAT_ShooterProjectilesPooled, Pool.Value.Num());
+	}
+	FreeProjectiles.Reset();
+
+	Super::Deinitialize();
+}
+
+AShooterProjectile* UShooterProjectilePoolSubsystem::SpawnProjectile(TSubclassOf<AShooterProjectile> Class, const FTransform& SpawnTransform, const FVector& ShootDirection, AActor* Owner, APawn* Instigator)
+{
+	if (Class == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (TArray<TWeakObjectPtr<AShooterProjectile>>* Pool = FreeProjectiles.Find(Class.Get()))
+	{
+		while (Pool->Num() > 0)
+		{
+			AShooterProjectile* Projectile = Pool->Pop(false).Get();
+			DEC_DWORD_STAT(STAT_ShooterProjectilesPooled);
+
+			// destroyed while in the pool, e.g. by a level reset
+			if (Projectile && !Projectile->IsPendingKillPending())
+			{
+				Projectile->LeavePool(SpawnTransform, ShootDirection, Owner, Instigator);
+
+				++NumReused;
+				INC_DWORD_STAT(STAT_ShooterProjectilesReused);
+				return Projectile;
+			}
+		}
+	}
+
+	return SpawnNewProjectile(Class, SpawnTransform, ShootDirection, Owner, Instigator);
+}
+
+bool UShooterProjectilePoolSubsystem::ReleaseProjectile(AShooterProjectile* Projectile)
+{
+	if (!ProjectilePooling || Projectile == nullptr || Projectile->IsPendingKillPending())
+	{
+		++NumDestroyed;
+		return false;
+	}
+
+	TArray<TWeakObjectPtr<AShooterProjectile>>& Pool = FreeProjectiles.FindOrAdd(Projectile->GetClass());
+	if (Pool.Num() >= ProjectilePoolSize)
+	{
+		++NumDestroyed;
+		return false;
+	}
+
+	Projectile->EnterPool();
+	Pool.Add(Projectile);
+	INC_DWORD_STAT(STAT_ShooterProjectilesPooled);
+
+	return true;
+}
+
+void UShooterProjectilePoolSubsystem::Prewarm(TSubclassOf<AShooterProjectile> Class, const FTransform& SpawnTransform)
+{
+	if (!ProjectilePooling || Class == nullptr)
+	{
+		return;
+	}
+
+	TArray<TWeakObjectPtr<AShooterProjectile>>& Pool = FreeProjectiles.FindOrAdd(Class.Get());
+	const int32 NumToSpawn = FMath::Min(ProjectilePoolPrewarm, ProjectilePoolSize) - Pool.Num();
+
+	for (int32 Idx = 0; Idx < NumToSpawn; ++Idx)
+	{
+		AShooterProjectile* Projectile = SpawnNewProjectile(Class, SpawnTransform, FVector::ZeroVector, nullptr, nullptr);
+		if (Projectile)
+		{
+			// spawned dormant, clients get it once (hidden) and keep it around for when it is woken up
+			Projectile->EnterPool();
+			Pool.Add(Projectile);
+			INC_DWORD_STAT(STAT_ShooterProjectilesPooled);
+		}
+	}
+}
+
+AShooterProjectile* UShooterProjectilePoolSubsystem::SpawnNewProjectile(TSubclassOf<AShooterProjectile> Class, const FTransform& SpawnTransform, const FVector& ShootDirection, AActor* Owner, APawn* Instigator)
+{
+	AShooterProjectile* Projectile = GetWorld()->SpawnActorDeferred<AShooterProjectile>(Class, SpawnTransform, Owner, Instigator);
+	if (Projectile)
+	{
+		FVector Direction = ShootDirection;
+		Projectile->InitVelocity(Direction);
+
+		UGameplayStatics::FinishSpawningActor(Projectile, SpawnTransform);
+
+		++NumSpawned;
+		INC_DWORD_STAT(STAT_ShooterProjectilesSpawned);
+	}
+
+	return Projectile;
+}
+
+void UShooterProjectilePoolSubsystem::OnPreGarbageCollect()
+{
+	GarbageCollectStartTime = FPlatformTime::Seconds();
+}
+
+void UShooterProjectilePoolSubsystem::OnPostGarbageCollect()
+{
+	if (GarbageCollectStartTime > 0.0)
+	{
+		++NumGarbageCollections;
+		GarbageCollectSeconds += FPlatformTime::Seconds() - GarbageCollectStartTime;
+		GarbageCollectStartTime = 0.0;
+	}
+}
@@ -8,6 +8,7 @@
 #include "Bots/ShooterAIController.h"
 #include "Online/ShooterPlayerState.h"
 #include "UI/ShooterHUD.h"
+#include "Online/ShooterPushModel.h"
 
 AShooterWeapon::AShooterWeapon(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -61,6 +62,8 @@ void AShooterWeapon::PostInitializeComponents()
 	{
 		CurrentAmmoInClip = WeaponConfig.AmmoPerClip;
 		CurrentAmmo = WeaponConfig.AmmoPerClip * WeaponConfig.InitialClips;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, CurrentAmmoInClip, this);
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, CurrentAmmo, this);
 	}
 
 	DetachMeshFromPawn();
@@ -142,6 +145,7 @@ void AShooterWeapon::OnUnEquip()
 	{
 		StopWeaponAnimation(ReloadAnim);
 		bPendingReload = false;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, bPendingReload, this);
 
 		GetWorldTimerManager().ClearTimer(TimerHandle_StopReload);
 		GetWorldTimerManager().ClearTimer(TimerHandle_ReloadWeapon);
@@ -169,7 +173,11 @@ void AShooterWeapon::OnLeaveInventory()
 {
 	if (IsAttachedToPawn())
 	{
-		SpawnPickup();
+		// pickups replicate, clients leaving the inventory through FShooterInventory still have MyPawn set here
+		if (GetLocalRole() == ROLE_Authority)
+		{
+			SpawnPickup();
+		}
 		OnUnEquip();
 	}
 
@@ -258,6 +266,7 @@ void AShooterWeapon::StartReload(bool bFromReplication)
 	if (bFromReplication || CanReload())
 	{
 		bPendingReload = true;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, bPendingReload, this);
 		DetermineWeaponState();
 
 		float AnimDuration = PlayWeaponAnimation(ReloadAnim);		
@@ -284,6 +293,7 @@ void AShooterWeapon::StopReload()
 	if (CurrentState == EWeaponState::Reloading)
 	{
 		bPendingReload = false;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, bPendingReload, this);
 		DetermineWeaponState();
 		StopWeaponAnimation(ReloadAnim);
 	}
@@ -361,6 +371,7 @@ void AShooterWeapon::GiveAmmo(int AddAmount)
 	const int32 MissingAmmo = FMath::Max(0, WeaponConfig.MaxAmmo - CurrentAmmo);
 	AddAmount = FMath::Min(AddAmount, MissingAmmo);
 	CurrentAmmo += AddAmount;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, CurrentAmmo, this);
 
 	AShooterAIController* BotAI = MyPawn ? Cast<AShooterAIController>(MyPawn->GetController()) : NULL;
 	if (BotAI)
@@ -382,11 +393,13 @@ void AShooterWeapon::UseAmmo()
 	if (!HasInfiniteAmmo())
 	{
 		CurrentAmmoInClip--;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, CurrentAmmoInClip, this);
 	}
 
 	if (!HasInfiniteAmmo() && !HasInfiniteClip())
 	{
 		CurrentAmmo--;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, CurrentAmmo, this);
 	}
 
 	AShooterAIController* BotAI = MyPawn ? Cast<AShooterAIController>(MyPawn->GetController()) : NULL;	
@@ -443,6 +456,7 @@ void AShooterWeapon::HandleFiring()
 			
 			// update firing FX on remote clients if function was called on server
 			BurstCounter++;
+			SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, BurstCounter, this);
 		}
 	}
 	else if (CanReload())
@@ -478,7 +492,7 @@ void AShooterWeapon::HandleFiring()
 		// local client will notify server
 		if (GetLocalRole() < ROLE_Authority)
 		{
-			ServerHandleFiring();
+			NotifyServerOfFiring();
 		}
 
 		// reload after firing last round
@@ -499,6 +513,11 @@ void AShooterWeapon::HandleFiring()
 	LastFireTime = GetWorld()->GetTimeSeconds();
 }
 
+void AShooterWeapon::NotifyServerOfFiring()
+{
+	ServerHandleFiring();
+}
+
 bool AShooterWeapon::ServerHandleFiring_Validate()
 {
 	return true;
@@ -517,6 +536,7 @@ void AShooterWeapon::ServerHandleFiring_Implementation()
 
 		// update firing FX on remote clients
 		BurstCounter++;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, BurstCounter, this);
 	}
 }
 
@@ -532,11 +552,13 @@ void AShooterWeapon::ReloadWeapon()
 	if (ClipDelta > 0)
 	{
 		CurrentAmmoInClip += ClipDelta;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, CurrentAmmoInClip, this);
 	}
 
 	if (HasInfiniteClip())
 	{
 		CurrentAmmo = FMath::Max(CurrentAmmoInClip, CurrentAmmo);
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, CurrentAmmo, this);
 	}
 }
 
@@ -606,6 +628,7 @@ void AShooterWeapon::OnBurstFinished()
 {
 	// stop firing FX on remote clients
 	BurstCounter = 0;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, BurstCounter, this);
 
 	// stop firing FX locally, unless it's a dedicated server
 	//if (GetNetMode() != NM_DedicatedServer)
@@ -783,6 +806,7 @@ void AShooterWeapon::SetOwningPawn(AShooterCharacter* NewOwner)
 	{
 		SetInstigator(NewOwner);
 		MyPawn = NewOwner;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon, MyPawn, this);
 		// net owner for RPC calls
 		SetOwner(NewOwner);
 	}	
@@ -932,13 +956,19 @@ void AShooterWeapon::GetLifetimeReplicatedProps( TArray< FLifetimeProperty > & O
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
-	DOREPLIFETIME( AShooterWeapon, MyPawn );
+	// push model: only compared when marked dirty (SHOOTER_MARK_PROPERTY_DIRTY)
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterWeapon, MyPawn, Params );
 
-	DOREPLIFETIME_CONDITION( AShooterWeapon, CurrentAmmo,		COND_OwnerOnly );
-	DOREPLIFETIME_CONDITION( AShooterWeapon, CurrentAmmoInClip, COND_OwnerOnly );
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterWeapon, CurrentAmmo,		Params );
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterWeapon, CurrentAmmoInClip,	Params );
 
-	DOREPLIFETIME_CONDITION( AShooterWeapon, BurstCounter,		COND_SkipOwner );
-	DOREPLIFETIME_CONDITION( AShooterWeapon, bPendingReload,	COND_SkipOwner );
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterWeapon, BurstCounter,		Params );
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterWeapon, bPendingReload,		Params );
 }
 
 USkeletalMeshComponent* AShooterWeapon::GetWeaponMesh() const
@@ -4,10 +4,124 @@
 #include "Weapons/ShooterWeapon_Instant.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Effects/ShooterImpactEffect.h"
+#include "Effects/ShooterEffectsSubsystem.h"
+#include "Online/ShooterPushModel.h"
+#include "Online/ShooterLagCompensationSubsystem.h"
+#include "Engine/PackageMapClient.h"
+
+static int32 ShotBatching = 1;
+FAutoConsoleVariableRef CVarShotBatching(
+	TEXT("p.ShotBatching"),
+	ShotBatching,
+	TEXT("Send the shots of a client frame to the server in one RPC.\n")
+	TEXT("0: one ServerNotifyHit / ServerNotifyMiss and ServerHandleFiring per shot, 1: Enable"),
+	ECVF_Default);
+
+/** more than this in one frame is a hacked client */
+static const int32 MaxShotsPerBatch = 32;
+
+/** how far a batched shot may start from the shooter's view on the server */
+static const float MaxShotOriginDistance = 200.0f;
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shot Batches Sent"), STAT_ShooterShotBatches, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Shots"), STAT_ShooterBatchedShots, STATGROUP_Game);
+
+/** shots a remote client regenerates from one HitNotify update, the older ones are not worth the traces */
+static const int32 MaxSimulatedShotsPerUpdate = 8;
+
+int32 FShooterSpreadStream::GetSeed(int32 ShotIndex) const
+{
+	// splitmix64 finalizer over key and index, neighbouring shots and weapons get unrelated seeds
+	uint64 Hash = ((uint64)Key << 32) | (uint32)ShotIndex;
+	Hash += 0x9E3779B97F4A7C15ull;
+	Hash = (Hash ^ (Hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+	Hash = (Hash ^ (Hash >> 27)) * 0x94D049BB133111EBull;
+	Hash ^= Hash >> 31;
+
+	return (int32)(uint32)(Hash >> 32);
+}
+
+FVector FShooterSpreadStream::GetShotDir(int32 ShotIndex, const FVector& AimDir, float ConeHalfAngle) const
+{
+	FRandomStream WeaponRandomStream(GetSeed(ShotIndex));
+	return WeaponRandomStream.VRandCone(AimDir, ConeHalfAngle, ConeHalfAngle);
+}
+
+bool FShooterBatchedShot::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint8 Flags = (bFired ? 1 : 0) | (bHandleFiring ? 2 : 0) | ((HitType & 3) << 2);
+	Ar.SerializeBits(&Flags, 4);
+
+	if (Ar.IsLoading())
+	{
+		bFired = (Flags & 1) != 0;
+		bHandleFiring = (Flags & 2) != 0;
+		HitType = (Flags >> 2) & 3;
+	}
+
+	if (!bFired)
+	{
+		return true;
+	}
+
+	bool bSerializedVector = true;
+	Origin.NetSerialize(Ar, Map, bSerializedVector);
+	bOutSuccess &= bSerializedVector;
+	ShootDir.NetSerialize(Ar, Map, bSerializedVector);
+	bOutSuccess &= bSerializedVector;
+
+	uint32 PackedShotIndex = (uint32)ShotIndex;
+	Ar.SerializeIntPacked(PackedShotIndex);
+
+	// hundredths of a degree
+	uint16 Spread = Ar.IsSaving() ? (uint16)FMath::Clamp(FMath::RoundToInt(ReticleSpread * 100.0f), 0, MAX_uint16) : 0;
+	Ar << Spread;
+
+	if (Ar.IsLoading())
+	{
+		ShotIndex = (int32)PackedShotIndex;
+		ReticleSpread = Spread / 100.0f;
+	}
+
+	if (HitType != Miss)
+	{
+		// whole centimeters, the impact point is rebuilt from Origin and ShootDir
+		uint32 Distance = Ar.IsSaving() ? (uint32)FMath::Max(FMath::RoundToInt(HitDistance), 0) : 0;
+		Ar.SerializeIntPacked(Distance);
+		HitDistance = Distance;
+	}
+
+	if (HitType == HitActor)
+	{
+		UObject* Actor = HitActor.Get();
+		Ar << Actor;
+		Ar << BoneName;
+
+		if (Ar.IsLoading())
+		{
+			HitActor = Cast<AActor>(Actor);
+		}
+	}
+
+	return true;
+}
 
 AShooterWeapon_Instant::AShooterWeapon_Instant(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	CurrentFiringSpread = 0.0f;
+	ShotCounter = 0;
+	LastSimulatedShotIndex = INDEX_NONE;
+}
+
+void AShooterWeapon_Instant::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(FlushPendingShotsHandle);
+	FlushPendingShotsHandle.Reset();
+	PendingShots.Reset();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -15,28 +129,27 @@ AShooterWeapon_Instant::AShooterWeapon_Instant(const FObjectInitializer& ObjectI
 
 void AShooterWeapon_Instant::FireWeapon()
 {
-	const int32 RandomSeed = FMath::Rand();
-	FRandomStream WeaponRandomStream(RandomSeed);
+	const int32 ShotIndex = ++ShotCounter;
 	const float CurrentSpread = GetCurrentSpread();
 	const float ConeHalfAngle = FMath::DegreesToRadians(CurrentSpread * 0.5f);
 
 	const FVector AimDir = GetAdjustedAim();
 	const FVector StartTrace = GetCameraDamageStartLocation(AimDir);
-	const FVector ShootDir = WeaponRandomStream.VRandCone(AimDir, ConeHalfAngle, ConeHalfAngle);
+	const FVector ShootDir = GetSpreadStream().GetShotDir(ShotIndex, AimDir, ConeHalfAngle);
 	const FVector EndTrace = StartTrace + ShootDir * InstantConfig.WeaponRange;
 
 	const FHitResult Impact = WeaponTrace(StartTrace, EndTrace);
-	ProcessInstantHit(Impact, StartTrace, ShootDir, RandomSeed, CurrentSpread);
+	ProcessInstantHit(Impact, StartTrace, ShootDir, ShotIndex, CurrentSpread);
 
 	CurrentFiringSpread = FMath::Min(InstantConfig.FiringSpreadMax, CurrentFiringSpread + InstantConfig.FiringSpreadIncrement);
 }
 
-bool AShooterWeapon_Instant::ServerNotifyHit_Validate(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+bool AShooterWeapon_Instant::ServerNotifyHit_Validate(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 ShotIndex, float ReticleSpread)
 {
 	return true;
 }
 
-void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 ShotIndex, float ReticleSpread)
 {
 	const float WeaponAngleDot = FMath::Abs(FMath::Sin(ReticleSpread * PI / 180.f));
 
@@ -56,42 +169,60 @@ void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Im
 				{
 					if (Impact.bBlockingHit)
 					{
-						ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
+						ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, ShotIndex, ReticleSpread);
 					}
 				}
 				// assume it told the truth about static things because the don't move and the hit 
 				// usually doesn't have significant gameplay implications
 				else if (Impact.GetActor()->IsRootComponentStatic() || Impact.GetActor()->IsRootComponentStationary())
 				{
-					ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
+					ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, ShotIndex, ReticleSpread);
 				}
 				else
 				{
-					// Get the component bounding box
-					const FBox HitBox = Impact.GetActor()->GetComponentsBoundingBox();
-
-					// calculate the box extent, and increase by a leeway
-					FVector BoxExtent = 0.5 * (HitBox.Max - HitBox.Min);
-					BoxExtent *= InstantConfig.ClientSideHitLeeway;
-
-					// avoid precision errors with really thin objects
-					BoxExtent.X = FMath::Max(20.0f, BoxExtent.X);
-					BoxExtent.Y = FMath::Max(20.0f, BoxExtent.Y);
-					BoxExtent.Z = FMath::Max(20.0f, BoxExtent.Z);
-
-					// Get the box center
-					const FVector BoxCenter = (HitBox.Min + HitBox.Max) * 0.5;
-
-					// if we are within client tolerance
-					if (FMath::Abs(Impact.Location.Z - BoxCenter.Z) < BoxExtent.Z &&
-						FMath::Abs(Impact.Location.X - BoxCenter.X) < BoxExtent.X &&
-						FMath::Abs(Impact.Location.Y - BoxCenter.Y) < BoxExtent.Y)
+					UShooterLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UShooterLagCompensationSubsystem>();
+					const FShooterHitboxHistory* TargetHistory = LagCompensation ? LagCompensation->FindHistory(Impact.GetActor()) : NULL;
+					if (TargetHistory)
 					{
-						ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
+						// rewind the target to where the client saw it when firing
+						const float ClientTime = LagCompensation->GetClientTime(GetInstigatorController());
+						if (TargetHistory->IsNear(ClientTime, Impact.Location, Impact.BoneName, InstantConfig.LagCompensationLeeway))
+						{
+							ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, ShotIndex, ReticleSpread);
+						}
+						else
+						{
+							UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (outside rewound hitboxes, %.0fms ago)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()), (GetWorld()->GetTimeSeconds() - ClientTime) * 1000.f);
+						}
 					}
 					else
 					{
-						UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (outside bounding box tolerance)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
+						// Get the component bounding box
+						const FBox HitBox = Impact.GetActor()->GetComponentsBoundingBox();
+
+						// calculate the box extent, and increase by a leeway
+						FVector BoxExtent = 0.5 * (HitBox.Max - HitBox.Min);
+						BoxExtent *= InstantConfig.ClientSideHitLeeway;
+
+						// avoid precision errors with really thin objects
+						BoxExtent.X = FMath::Max(20.0f, BoxExtent.X);
+						BoxExtent.Y = FMath::Max(20.0f, BoxExtent.Y);
+						BoxExtent.Z = FMath::Max(20.0f, BoxExtent.Z);
+
+						// Get the box center
+						const FVector BoxCenter = (HitBox.Min + HitBox.Max) * 0.5;
+
+						// if we are within client tolerance
+						if (FMath::Abs(Impact.Location.Z - BoxCenter.Z) < BoxExtent.Z &&
+							FMath::Abs(Impact.Location.X - BoxCenter.X) < BoxExtent.X &&
+							FMath::Abs(Impact.Location.Y - BoxCenter.Y) < BoxExtent.Y)
+						{
+							ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, ShotIndex, ReticleSpread);
+						}
+						else
+						{
+							UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side hit of %s (outside bounding box tolerance)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
+						}
 					}
 				}
 			}
@@ -107,19 +238,20 @@ void AShooterWeapon_Instant::ServerNotifyHit_Implementation(const FHitResult& Im
 	}
 }
 
-bool AShooterWeapon_Instant::ServerNotifyMiss_Validate(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+bool AShooterWeapon_Instant::ServerNotifyMiss_Validate(FVector_NetQuantizeNormal ShootDir, int32 ShotIndex, float ReticleSpread)
 {
 	return true;
 }
 
-void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantizeNormal ShootDir, int32 ShotIndex, float ReticleSpread)
 {
 	const FVector Origin = GetMuzzleLocation();
 
 	// play FX on remote clients
 	HitNotify.Origin = Origin;
-	HitNotify.RandomSeed = RandomSeed;
+	HitNotify.ShotIndex = ShotIndex;
 	HitNotify.ReticleSpread = ReticleSpread;
+	SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon_Instant, HitNotify, this);
 
 	// play FX locally
 	if (GetNetMode() != NM_DedicatedServer)
@@ -129,36 +261,166 @@ void AShooterWeapon_Instant::ServerNotifyMiss_Implementation(FVector_NetQuantize
 	}
 }
 
-void AShooterWeapon_Instant::ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 ShotIndex, float ReticleSpread)
 {
 	if (MyPawn && MyPawn->IsLocallyControlled() && GetNetMode() == NM_Client)
 	{
-		// if we're a client and we've hit something that is being controlled by the server
-		if (Impact.GetActor() && Impact.GetActor()->GetRemoteRole() == ROLE_Authority)
+		// if we're a client and we've hit something that is being controlled by the server, or nothing but the world
+		if ((Impact.GetActor() && Impact.GetActor()->GetRemoteRole() == ROLE_Authority) || Impact.GetActor() == NULL)
+		{
+			NotifyServerOfShot(Impact, Origin, ShootDir, ShotIndex, ReticleSpread);
+		}
+	}
+
+	// process a confirmed hit
+	ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, ShotIndex, ReticleSpread);
+}
+
+void AShooterWeapon_Instant::NotifyServerOfShot(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 ShotIndex, float ReticleSpread)
+{
+	if (!ShotBatching)
+	{
+		if (Impact.bBlockingHit)
 		{
 			// notify the server of the hit
-			ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread);
+			ServerNotifyHit(Impact, ShootDir, ShotIndex, ReticleSpread);
 		}
-		else if (Impact.GetActor() == NULL)
+		else
 		{
-			if (Impact.bBlockingHit)
+			// notify server of the miss
+			ServerNotifyMiss(ShootDir, ShotIndex, ReticleSpread);
+		}
+		return;
+	}
+
+	FShooterBatchedShot& Shot = AddPendingShot();
+	Shot.bFired = true;
+	Shot.Origin = Origin;
+	Shot.ShootDir = ShootDir;
+	Shot.ShotIndex = ShotIndex;
+	Shot.ReticleSpread = ReticleSpread;
+
+	if (Impact.bBlockingHit)
+	{
+		Shot.HitType = Impact.GetActor() ? FShooterBatchedShot::HitActor : FShooterBatchedShot::HitWorld;
+		Shot.HitDistance = FVector::Dist(Origin, Impact.Location);
+		Shot.HitActor = Impact.GetActor();
+		Shot.BoneName = Impact.BoneName;
+	}
+}
+
+void AShooterWeapon_Instant::NotifyServerOfFiring()
+{
+	if (!ShotBatching)
+	{
+		Super::NotifyServerOfFiring();
+		return;
+	}
+
+	// goes with the shot FireWeapon just queued, if it fired one
+	if (PendingShots.Num() == 0 || !PendingShots.Last().bFired || PendingShots.Last().bHandleFiring)
+	{
+		AddPendingShot();
+	}
+
+	PendingShots.Last().bHandleFiring = true;
+}
+
+FShooterBatchedShot& AShooterWeapon_Instant::AddPendingShot()
+{
+	// after every actor and timer ticked, right before the net driver sends this frame's packets
+	if (!FlushPendingShotsHandle.IsValid())
+	{
+		FlushPendingShotsHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &AShooterWeapon_Instant::FlushPendingShots);
+	}
+
+	return PendingShots.AddDefaulted_GetRef();
+}
+
+void AShooterWeapon_Instant::FlushPendingShots(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	FWorldDelegates::OnWorldPostActorTick.Remove(FlushPendingShotsHandle);
+	FlushPendingShotsHandle.Reset();
+
+	for (int32 FirstShot = 0; FirstShot < PendingShots.Num(); FirstShot += MaxShotsPerBatch)
+	{
+		const int32 NumShots = FMath::Min(PendingShots.Num() - FirstShot, MaxShotsPerBatch);
+		ServerFireShots(NumShots == PendingShots.Num() ? PendingShots : TArray<FShooterBatchedShot>(PendingShots.GetData() + FirstShot, NumShots));
+
+		INC_DWORD_STAT(STAT_ShooterShotBatches);
+		INC_DWORD_STAT_BY(STAT_ShooterBatchedShots, NumShots);
+	}
+
+	PendingShots.Reset();
+}
+
+bool AShooterWeapon_Instant::ServerFireShots_Validate(const TArray<FShooterBatchedShot>& Shots)
+{
+	return Shots.Num() <= MaxShotsPerBatch;
+}
+
+void AShooterWeapon_Instant::ServerFireShots_Implementation(const TArray<FShooterBatchedShot>& Shots)
+{
+	const FVector ViewLocation = MyPawn ? MyPawn->GetPawnViewLocation() : FVector::ZeroVector;
+
+	// same order as the client: the shot, then the HandleFiring that fired it
+	for (const FShooterBatchedShot& Shot : Shots)
+	{
+		if (Shot.bFired)
+		{
+			if (MyPawn && FVector::DistSquared(Shot.Origin, ViewLocation) > FMath::Square(MaxShotOriginDistance))
+			{
+				UE_LOG(LogShooterWeapon, Log, TEXT("%s Rejected client side shot (starts %.0f away from the view)"), *GetNameSafe(this), FVector::Dist(Shot.Origin, ViewLocation));
+			}
+			else if (Shot.HitType == FShooterBatchedShot::Miss)
 			{
-				// notify the server of the hit
-				ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread);
+				ServerNotifyMiss_Implementation(Shot.ShootDir, Shot.ShotIndex, Shot.ReticleSpread);
 			}
 			else
 			{
-				// notify server of the miss
-				ServerNotifyMiss(ShootDir, RandomSeed, ReticleSpread);
+				ServerNotifyHit_Implementation(MakeHitResult(Shot), Shot.ShootDir, Shot.ShotIndex, Shot.ReticleSpread);
 			}
 		}
+
+		if (Shot.bHandleFiring)
+		{
+			ServerHandleFiring_Implementation();
+		}
 	}
+}
 
-	// process a confirmed hit
-	ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
+FHitResult AShooterWeapon_Instant::MakeHitResult(const FShooterBatchedShot& Shot) const
+{
+	FHitResult Impact(ForceInit);
+	Impact.bBlockingHit = true;
+	Impact.TraceStart = Shot.Origin;
+	Impact.TraceEnd = Shot.Origin + Shot.ShootDir * InstantConfig.WeaponRange;
+	Impact.Distance = Shot.HitDistance;
+	Impact.Time = InstantConfig.WeaponRange > 0.0f ? FMath::Clamp(Shot.HitDistance / InstantConfig.WeaponRange, 0.0f, 1.0f) : 0.0f;
+	Impact.Location = Shot.Origin + Shot.ShootDir * Shot.HitDistance;
+	Impact.ImpactPoint = Impact.Location;
+	Impact.Normal = -Shot.ShootDir;
+	Impact.ImpactNormal = Impact.Normal;
+	Impact.BoneName = Shot.BoneName;
+
+	AActor* HitActor = Shot.HitActor.Get();
+	if (HitActor)
+	{
+		// bones are on the character mesh, everything else is the root
+		ACharacter* HitCharacter = Cast<ACharacter>(HitActor);
+		Impact.Actor = HitActor;
+		Impact.Component = (HitCharacter && !Shot.BoneName.IsNone()) ? HitCharacter->GetMesh() : Cast<UPrimitiveComponent>(HitActor->GetRootComponent());
+	}
+
+	return Impact;
 }
 
-void AShooterWeapon_Instant::ProcessInstantHit_Confirmed(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::ProcessInstantHit_Confirmed(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 ShotIndex, float ReticleSpread)
 {
 	// handle damage
 	if (ShouldDealDamage(Impact.GetActor()))
@@ -170,8 +432,9 @@ void AShooterWeapon_Instant::ProcessInstantHit_Confirmed(const FHitResult& Impac
 	if (GetLocalRole() == ROLE_Authority)
 	{
 		HitNotify.Origin = Origin;
-		HitNotify.RandomSeed = RandomSeed;
+		HitNotify.ShotIndex = ShotIndex;
 		HitNotify.ReticleSpread = ReticleSpread;
+		SHOOTER_MARK_PROPERTY_DIRTY(AShooterWeapon_Instant, HitNotify, this);
 	}
 
 	// play FX locally
@@ -223,6 +486,21 @@ void AShooterWeapon_Instant::OnBurstFinished()
 //////////////////////////////////////////////////////////////////////////
 // Weapon usage helpers
 
+FShooterSpreadStream AShooterWeapon_Instant::GetSpreadStream()
+{
+	// the net GUID is the id the server and all clients agree on, standalone games have none and use 0
+	uint32 Key = 0;
+
+	UNetDriver* NetDriver = GetNetDriver();
+	if (NetDriver && NetDriver->GuidCache.IsValid())
+	{
+		const FNetworkGUID NetGUID = GetLocalRole() == ROLE_Authority ? NetDriver->GuidCache->GetOrAssignNetGUID(this) : NetDriver->GuidCache->GetNetGUID(this);
+		Key = NetGUID.Value;
+	}
+
+	return FShooterSpreadStream(Key);
+}
+
 float AShooterWeapon_Instant::GetCurrentSpread() const
 {
 	float FinalSpread = InstantConfig.WeaponSpread + CurrentFiringSpread;
@@ -240,17 +518,25 @@ float AShooterWeapon_Instant::GetCurrentSpread() const
 
 void AShooterWeapon_Instant::OnRep_HitNotify()
 {
-	SimulateInstantHit(HitNotify.Origin, HitNotify.RandomSeed, HitNotify.ReticleSpread);
+	// replication only sends the newest shot, regenerate the ones fired since the last update as well
+	int32 FirstShotIndex = HitNotify.ShotIndex;
+	if (LastSimulatedShotIndex != INDEX_NONE && HitNotify.ShotIndex > LastSimulatedShotIndex)
+	{
+		FirstShotIndex = FMath::Max(LastSimulatedShotIndex + 1, HitNotify.ShotIndex - MaxSimulatedShotsPerUpdate + 1);
+	}
+
+	for (int32 ShotIndex = FirstShotIndex; ShotIndex <= HitNotify.ShotIndex; ++ShotIndex)
+	{
+		SimulateInstantHit(HitNotify.Origin, ShotIndex, HitNotify.ReticleSpread);
+	}
+
+	LastSimulatedShotIndex = FMath::Max(LastSimulatedShotIndex, HitNotify.ShotIndex);
 }
 
-void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32 RandomSeed, float ReticleSpread)
+void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32 ShotIndex, float ReticleSpread)
 {
-	FRandomStream WeaponRandomStream(RandomSeed);
-	const float ConeHalfAngle = FMath::DegreesToRadians(ReticleSpread * 0.5f);
-
 	const FVector StartTrace = ShotOrigin;
-	const FVector AimDir = GetAdjustedAim();
-	const FVector ShootDir = WeaponRandomStream.VRandCone(AimDir, ConeHalfAngle, ConeHalfAngle);
+	const FVector ShootDir = GetSimulatedShotDir(ShotIndex, ReticleSpread);
 	const FVector EndTrace = StartTrace + ShootDir * InstantConfig.WeaponRange;
 
 	FHitResult Impact = WeaponTrace(StartTrace, EndTrace);
@@ -265,6 +551,12 @@ void AShooterWeapon_Instant::SimulateInstantHit(const FVector& ShotOrigin, int32
 	}
 }
 
+FVector AShooterWeapon_Instant::GetSimulatedShotDir(int32 ShotIndex, float ReticleSpread)
+{
+	const float ConeHalfAngle = FMath::DegreesToRadians(ReticleSpread * 0.5f);
+	return GetSpreadStream().GetShotDir(ShotIndex, GetAdjustedAim(), ConeHalfAngle);
+}
+
 void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 {
 	if (ImpactTemplate && Impact.bBlockingHit)
@@ -281,11 +573,9 @@ void AShooterWeapon_Instant::SpawnImpactEffects(const FHitResult& Impact)
 		}
 
 		FTransform const SpawnTransform(Impact.ImpactNormal.Rotation(), Impact.ImpactPoint);
-		AShooterImpactEffect* EffectActor = GetWorld()->SpawnActorDeferred<AShooterImpactEffect>(ImpactTemplate, SpawnTransform);
-		if (EffectActor)
+		if (UShooterEffectsSubsystem* Effects = GetWorld()->GetSubsystem<UShooterEffectsSubsystem>())
 		{
-			EffectActor->SurfaceHit = UseImpact;
-			UGameplayStatics::FinishSpawningActor(EffectActor, SpawnTransform);
+			Effects->SpawnImpactEffect(ImpactTemplate, SpawnTransform, UseImpact);
 		}
 	}
 }
@@ -308,5 +598,8 @@ void AShooterWeapon_Instant::GetLifetimeReplicatedProps( TArray< FLifetimeProper
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
-	DOREPLIFETIME_CONDITION( AShooterWeapon_Instant, HitNotify, COND_SkipOwner );
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST( AShooterWeapon_Instant, HitNotify, Params );
 }
\ No newline at end of file
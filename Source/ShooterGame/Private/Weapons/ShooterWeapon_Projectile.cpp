@@ -3,11 +3,25 @@
 #include "ShooterGame.h"
 #include "Weapons/ShooterWeapon_Projectile.h"
 #include "Weapons/ShooterProjectile.h"
+#include "Weapons/ShooterProjectilePoolSubsystem.h"
+#include "Weapons/ShooterProjectileManager.h"
 
 AShooterWeapon_Projectile::AShooterWeapon_Projectile(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 }
 
+void AShooterWeapon_Projectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// have a few projectiles ready before the first shot
+	UShooterProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UShooterProjectilePoolSubsystem>();
+	if (GetLocalRole() == ROLE_Authority && Pool && !AShooterProjectileManager::IsEnabled())
+	{
+		Pool->Prewarm(ProjectileConfig.ProjectileClass, GetActorTransform());
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Weapon usage
 
@@ -71,15 +85,21 @@ bool AShooterWeapon_Projectile::ServerFireProjectile_Validate(FVector Origin, FV
 
 void AShooterWeapon_Projectile::ServerFireProjectile_Implementation(FVector Origin, FVector_NetQuantizeNormal ShootDir)
 {
-	FTransform SpawnTM(ShootDir.Rotation(), Origin);
-	AShooterProjectile* Projectile = Cast<AShooterProjectile>(UGameplayStatics::BeginDeferredActorSpawnFromClass(this, ProjectileConfig.ProjectileClass, SpawnTM));
-	if (Projectile)
+	if (AShooterProjectileManager::IsEnabled())
 	{
-		Projectile->SetInstigator(GetInstigator());
-		Projectile->SetOwner(this);
-		Projectile->InitVelocity(ShootDir);
+		AShooterProjectileManager* Manager = AShooterProjectileManager::Get(GetWorld());
+		if (Manager)
+		{
+			Manager->SpawnProjectile(ProjectileConfig, Origin, ShootDir, GetInstigator());
+		}
+		return;
+	}
 
-		UGameplayStatics::FinishSpawningActor(Projectile, SpawnTM);
+	FTransform SpawnTM(ShootDir.Rotation(), Origin);
+	UShooterProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UShooterProjectilePoolSubsystem>();
+	if (Pool)
+	{
+		Pool->SpawnProjectile(ProjectileConfig.ProjectileClass, SpawnTM, ShootDir, this, GetInstigator());
 	}
 }
 
@@ -16,4 +16,14 @@ class AShooterBot : public AShooterCharacter
 	virtual bool IsFirstPerson() const override;
 
 	virtual void FaceRotation(FRotator NewRotation, float DeltaTime = 0.f) override;
+
+	/** [server] hands movement LOD to UShooterBotMovementLODSubsystem */
+	virtual void PostInitializeComponents() override;
+
+	virtual void Destroyed() override;
+
+protected:
+
+	/** takes movement LOD back first, dying resets the mesh tick option */
+	virtual void OnDeath(float KillingDamage, struct FDamageEvent const& DamageEvent, class APawn* InstigatingPawn, class AActor* DamageCauser) override;
 };
\ No newline at end of file
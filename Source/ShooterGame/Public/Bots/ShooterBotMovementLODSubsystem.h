@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Components/SkinnedMeshComponent.h"
+#include "ShooterBotMovementLODSubsystem.generated.h"
+
+class AShooterBot;
+
+/**
+ * [server] Movement LOD for bots no human player is near.
+ *
+ * A few times a second every registered bot is checked against the view targets of all player controllers. Bots
+ * outside their net cull distance from every one of them, so not relevant to any connection, tick movement every
+ * p.BotMovementLODTickInterval with sub-steps up to p.BotMovementLODMaxTimeStep, and their mesh only ticks montages.
+ * They go back to full rate while still outside that distance, with a margin for how far a player and the bot can close in
+ * between checks (p.BotMovementLODClosingSpeed), so a bot is at full rate by the time it replicates (hysteresis on the way out).
+ */
+UCLASS()
+class UShooterBotMovementLODSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Begin USubsystem interface
+	virtual void Deinitialize() override;
+	// End USubsystem interface
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject interface
+
+	/** starts managing Bot's movement LOD, its movement and mesh have to be set up */
+	void Register(AShooterBot* Bot);
+
+	/** stops managing Bot, back at full rate */
+	void Unregister(AShooterBot* Bot);
+
+	/** bots currently at reduced rate */
+	int32 GetNumReducedBots() const { return NumReducedBots; }
+
+private:
+
+	struct FTrackedBot
+	{
+		TWeakObjectPtr<AShooterBot> Bot;
+
+		bool bReduced = false;
+
+		/** full rate settings, restored when the bot comes back */
+		float MovementTickInterval = 0.0f;
+		float MaxSimulationTimeStep = 0.0f;
+		EVisibilityBasedAnimTickOption MeshAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	};
+
+	void SetReduced(FTrackedBot& Tracked, bool bReduced);
+
+	TArray<FTrackedBot> TrackedBots;
+
+	int32 NumReducedBots = 0;
+
+	/** world time of the last update */
+	float LastUpdateTime = -1.0f;
+};
@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterEffectsSubsystem.generated.h"
+
+class AShooterImpactEffect;
+class AShooterExplosionEffect;
+
+/**
+ * Plays impact and explosion effects with pooled actors and a budget.
+ *
+ * Effects further than p.EffectsCullDistance from every local view are skipped. Effects outside the view, past
+ * p.EffectsMaxPerFrame this frame or past p.EffectsMaxActive still playing only play their sound, without an actor.
+ * Playing effects are watched from one tick, which also fades all explosion lights, and go back to the pool of their
+ * class (p.EffectPoolSize) once their particles and light are done. Pooled actors restart their own particle and decal
+ * components on reuse, so a decal lasts until its life span is over or its actor is played again.
+ */
+UCLASS()
+class UShooterEffectsSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Begin USubsystem interface
+	virtual void Deinitialize() override;
+	// End USubsystem interface
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject interface
+
+	/** plays an impact effect of Class on SurfaceHit */
+	void SpawnImpactEffect(TSubclassOf<AShooterImpactEffect> Class, const FTransform& SpawnTransform, const FHitResult& SurfaceHit);
+
+	/** plays an explosion effect of Class on SurfaceHit */
+	void SpawnExplosionEffect(TSubclassOf<AShooterExplosionEffect> Class, const FTransform& SpawnTransform, const FHitResult& SurfaceHit);
+
+private:
+
+	enum class EEffectDetail : uint8
+	{
+		None,
+		SoundOnly,
+		Full,
+	};
+
+	struct FActiveEffect
+	{
+		TWeakObjectPtr<AActor> Effect;
+
+		/** set for explosions, their light is faded from Tick */
+		TWeakObjectPtr<AShooterExplosionEffect> Explosion;
+
+		TWeakObjectPtr<UParticleSystemComponent> Particles;
+
+		float StartTime;
+
+		bool bLightOn;
+	};
+
+	/** how much of an effect at Location to play, counts it against the budget when it gets an actor */
+	EEffectDetail GetEffectDetail(const FVector& Location);
+
+	/** free actor of Class from the pool, or a new one */
+	template<typename T>
+	T* AcquireEffect(TSubclassOf<T> Class, const FTransform& SpawnTransform);
+
+	/** back to the pool or destroyed */
+	void ReleaseEffect(AActor* Effect);
+
+	TArray<FActiveEffect> ActiveEffects;
+
+	/** free effects by class */
+	TMap<FObjectKey, TArray<TWeakObjectPtr<AActor>>> FreeEffects;
+
+	uint64 BudgetFrame = 0;
+	int32 NumEffectsThisFrame = 0;
+};
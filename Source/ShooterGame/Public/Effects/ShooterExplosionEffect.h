@@ -22,6 +22,14 @@ private:
 	/** explosion light */
 	UPROPERTY(VisibleDefaultsOnly, Category=Effect)
 	UPointLightComponent* ExplosionLight;
+
+	/** particles of managed effects, restarted on every reuse */
+	UPROPERTY(VisibleDefaultsOnly, Category=Effect)
+	UParticleSystemComponent* ExplosionParticles;
+
+	/** decal of managed effects, moved to the surface on every reuse */
+	UPROPERTY(VisibleDefaultsOnly, Category=Effect)
+	UDecalComponent* ExplosionDecal;
 public:
 
 	/** how long keep explosion light on? */
@@ -40,9 +48,18 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category=Surface)
 	FHitResult SurfaceHit;
 
+	/** played and recycled by UShooterEffectsSubsystem instead of on spawn, set before spawning finishes */
+	bool bManaged;
+
 	/** update fading light */
 	virtual void Tick(float DeltaSeconds) override;
 
+	/** play particles, sound and decal for SurfaceHit and turn the light on, returns the particles */
+	UParticleSystemComponent* PlayEffect();
+
+	/** fades the light TimeAlive into the effect, false (and the light hidden) once it is out */
+	bool UpdateLight(float TimeAlive);
+
 protected:
 	/** spawn explosion */
 	virtual void BeginPlay() override;
@@ -52,7 +69,20 @@ private:
 	/** Point light component name */
 	FName ExplosionLightComponentName;
 
+	/** intensity of the light before fading */
+	float ExplosionLightIntensity;
+
+	/** hides ExplosionDecal once its life span is over */
+	FTimerHandle TimerHandle_HideDecal;
+
+	/** hide ExplosionDecal */
+	void HideDecal();
+
 public:
 	/** Returns ExplosionLight subobject **/
 	FORCEINLINE UPointLightComponent* GetExplosionLight() const { return ExplosionLight; }
+	/** Returns ExplosionParticles subobject **/
+	FORCEINLINE UParticleSystemComponent* GetExplosionParticles() const { return ExplosionParticles; }
+	/** Returns ExplosionDecal subobject **/
+	FORCEINLINE UDecalComponent* GetExplosionDecal() const { return ExplosionDecal; }
 };
@@ -94,14 +94,44 @@ class AShooterImpactEffect : public AActor
 	UPROPERTY(BlueprintReadOnly, Category=Surface)
 	FHitResult SurfaceHit;
 
+	/** played and recycled by UShooterEffectsSubsystem instead of on spawn, set before spawning finishes */
+	bool bManaged;
+
 	/** spawn effect */
 	virtual void PostInitializeComponents() override;
 
+	/** play particles, sound and decal for SurfaceHit, returns the particles */
+	UParticleSystemComponent* PlayEffect();
+
+private:
+	/** particles of managed effects, restarted with the surface's FX on every reuse */
+	UPROPERTY(VisibleDefaultsOnly, Category=Effect)
+	UParticleSystemComponent* ImpactParticles;
+
+	/** decal of managed effects, moved to the surface on every reuse */
+	UPROPERTY(VisibleDefaultsOnly, Category=Effect)
+	UDecalComponent* ImpactDecal;
+
+	/** hides ImpactDecal once its life span is over */
+	FTimerHandle TimerHandle_HideDecal;
+
+	/** hide ImpactDecal */
+	void HideDecal();
+
 protected:
 
+	/** the subsystem plays only the sound of effects over its budget */
+	friend class UShooterEffectsSubsystem;
+
 	/** get FX for material type */
 	UParticleSystem* GetImpactFX(TEnumAsByte<EPhysicalSurface> SurfaceType) const;
 
 	/** get sound for material type */
 	USoundCue* GetImpactSound(TEnumAsByte<EPhysicalSurface> SurfaceType) const;
+
+public:
+	/** Returns ImpactParticles subobject **/
+	FORCEINLINE UParticleSystemComponent* GetImpactParticles() const { return ImpactParticles; }
+	/** Returns ImpactDecal subobject **/
+	FORCEINLINE UDecalComponent* GetImpactDecal() const { return ImpactDecal; }
 };
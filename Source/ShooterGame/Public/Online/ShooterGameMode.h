@@ -25,6 +25,9 @@ class AShooterGameMode : public AGameMode
 
 	virtual void PreInitializeComponents() override;
 
+	/** updates the pickup replication stats */
+	virtual void Tick(float DeltaSeconds) override;
+
 	/** Initialize the game. This is called before actors' PreInitializeComponents. */
 	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
 
@@ -159,4 +162,7 @@ public:
 	UPROPERTY()
 	TArray<AShooterPickup*> LevelPickups;
 
+	/** LevelPickups the net driver replicated since the last tick, counted in AShooterPickup::PreReplication */
+	int32 NumPickupsReplicated;
+
 };
@@ -2,11 +2,72 @@
 
 #pragma once
 
+#include "Engine/NetSerialization.h"
 #include "ShooterGameState.generated.h"
 
 /** ranked PlayerState map, created from the GameState */
 typedef TMap<int32, TWeakObjectPtr<AShooterPlayerState> > RankedPlayerMap; 
 
+/** one kill in the kill feed */
+USTRUCT()
+struct FShooterKillFeedEntry : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	class AShooterPlayerState* Killer = nullptr;
+
+	UPROPERTY()
+	class AShooterPlayerState* Victim = nullptr;
+
+	/** there was a killer on the server, a null Killer on clients means it isn't resolved yet */
+	UPROPERTY()
+	bool bHasKiller = false;
+
+	UPROPERTY()
+	TSubclassOf<UDamageType> DamageType;
+
+	/** server world time of the kill */
+	UPROPERTY()
+	float Time = 0.f;
+
+	/** local players have been told about it */
+	bool bHandled = false;
+
+	void PostReplicatedAdd(const struct FShooterKillFeed& InArraySerializer);
+	void PostReplicatedChange(const struct FShooterKillFeed& InArraySerializer);
+};
+
+/**
+ * Recent kills, replicated with the game state instead of reliable RPCs per death.
+ * Kills from the same frame go out in one delta per connection, clients pass each new entry on to their local player controllers.
+ */
+USTRUCT()
+struct FShooterKillFeed : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FShooterKillFeedEntry> Items;
+
+	/** game state this feed belongs to */
+	class AShooterGameState* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FShooterKillFeedEntry, FShooterKillFeed>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterKillFeed> : public TStructOpsTypeTraitsBase2<FShooterKillFeed>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
 UCLASS()
 class AShooterGameState : public AGameState
 {
@@ -30,8 +91,23 @@ public:
 	UPROPERTY(Transient, Replicated)
 	bool bTimerPaused;
 
+	/** recent kills, for HUD death messages and kill achievements */
+	UPROPERTY(Transient, Replicated)
+	FShooterKillFeed KillFeed;
+
+	/** [server] adds a kill to the feed */
+	void AddKill(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState);
+
+	/** [client] a feed entry was received or its player states were resolved */
+	void OnKillFeedEntryReceived(FShooterKillFeedEntry& Entry);
+
 	/** gets ranked PlayerState map for specific team */
 	void GetRankedMap(int32 TeamIndex, RankedPlayerMap& OutRankedMap) const;	
 
 	void RequestFinishAndExitToMainMenu();
+
+protected:
+
+	/** death message for all local players, OnKill for the local killer */
+	void NotifyLocalPlayersAboutKill(const FShooterKillFeedEntry& Entry);
 };
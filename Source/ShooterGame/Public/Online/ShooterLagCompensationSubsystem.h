@@ -0,0 +1,138 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShooterLagCompensationSubsystem.generated.h"
+
+class AShooterCharacter;
+
+/**
+ * Where a pawn's capsule and hitboxes were over the last MaxFrames recorded frames.
+ * Fixed size ring buffer, recording and querying never allocate.
+ */
+class SHOOTERGAME_API FShooterHitboxHistory
+{
+public:
+
+	/** bodies of the physics asset past this many are not recorded */
+	static constexpr int32 MaxHitboxes = 16;
+
+	/** frames kept per pawn */
+	static constexpr int32 MaxFrames = 64;
+
+	/** one recorded frame, hitboxes in world space */
+	struct FFrame
+	{
+		float Time = 0.f;
+		FVector CapsuleLocation;
+		FVector HitboxLocations[MaxHitboxes];
+		FQuat HitboxRotations[MaxHitboxes];
+	};
+
+	/**
+	 * Sets the shapes to record and clears the history.
+	 *
+	 * @param	InCapsuleRadius		Radius of the (upright) collision capsule
+	 * @param	InCapsuleHalfHeight	Half height of the collision capsule
+	 * @param	InBones				Bone of each hitbox, at most MaxHitboxes
+	 * @param	InLocalBoxes		Bounds of each hitbox in its bone's space
+	 */
+	void Init(float InCapsuleRadius, float InCapsuleHalfHeight, TArrayView<const FName> InBones, TArrayView<const FBox> InLocalBoxes);
+
+	/** forgets all recorded frames */
+	void Reset();
+
+	/** records a frame, HitboxTransforms are the world transforms of the bones passed to Init */
+	void Record(float Time, const FVector& CapsuleLocation, TArrayView<const FTransform> HitboxTransforms);
+
+	/** frame at Time, interpolated between the recorded ones and clamped to the recorded range. false if nothing was recorded */
+	bool Sample(float Time, FFrame& OutFrame) const;
+
+	/**
+	 * Was Location within Leeway of the pawn at Time?
+	 * If BoneName is one of the hitboxes only that one is tested, otherwise all of them and the capsule.
+	 */
+	bool IsNear(float Time, const FVector& Location, FName BoneName, float Leeway) const;
+
+	int32 GetNumHitboxes() const { return NumHitboxes; }
+	int32 GetNumFrames() const { return NumFrames; }
+
+	/** time of the oldest recorded frame, queries before it get that frame */
+	float GetOldestTime() const;
+
+private:
+
+	bool IsNearHitbox(const FFrame& Frame, int32 HitboxIndex, const FVector& Location, float LeewaySq) const;
+
+	FFrame Frames[MaxFrames];
+
+	/** most recent entry of Frames */
+	int32 NewestIndex = INDEX_NONE;
+	int32 NumFrames = 0;
+
+	int32 NumHitboxes = 0;
+	FName Bones[MaxHitboxes];
+	FBox LocalBoxes[MaxHitboxes];
+
+	float CapsuleRadius = 0.f;
+	float CapsuleHalfHeight = 0.f;
+};
+
+/**
+ * [server] Lag compensation for client side hits.
+ *
+ * Every frame records where each registered pawn's capsule and hitboxes (the bodies of its physics asset) are. Hit
+ * validation looks up the target's history at the time the shooter saw it (GetClientTime) instead of trusting an
+ * inflated bounding box around where it is now. Rewinding is capped at p.LagCompensationMaxRewind.
+ */
+UCLASS()
+class UShooterLagCompensationSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Begin USubsystem interface
+	virtual void Deinitialize() override;
+	// End USubsystem interface
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject interface
+
+	/** starts recording Pawn, its mesh and capsule have to be set up */
+	void Register(AShooterCharacter* Pawn);
+
+	/** stops recording Pawn */
+	void Unregister(AShooterCharacter* Pawn);
+
+	/** history of Target, null if it isn't recorded or lag compensation is disabled */
+	const FShooterHitboxHistory* FindHistory(const AActor* Target) const;
+
+	/** world time the shooter saw the world at when firing: its ping and the client interpolation delay ago, at most p.LagCompensationMaxRewind */
+	float GetClientTime(const AController* Shooter) const;
+
+private:
+
+	struct FTrackedPawn
+	{
+		TWeakObjectPtr<AShooterCharacter> Pawn;
+
+		/** mesh bone index of each hitbox */
+		int32 BoneIndices[FShooterHitboxHistory::MaxHitboxes];
+
+		FShooterHitboxHistory History;
+	};
+
+	TMap<FObjectKey, TUniquePtr<FTrackedPawn>> TrackedPawns;
+
+	/** histories of unregistered pawns, reused for the next ones instead of reallocating on every respawn */
+	TArray<TUniquePtr<FTrackedPawn>> FreeTrackedPawns;
+};
@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "ShooterNetVisibilitySubsystem.generated.h"
+
+/**
+ * [server] Batched, cached line of sight tests between connection viewers and replicated actors.
+ *
+ * Used by AShooterCharacter::IsReplicationPausedForConnection. Rather than tracing synchronously for every
+ * connection on every replication pass, each viewer/target pair is traced through the async trace API and the
+ * result is reused for a few frames, or for as long as neither end moves further than a threshold.
+ * Results arrive one frame later, so a pair that has never been tested is reported as visible.
+ */
+UCLASS()
+class UShooterNetVisibilitySubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	// Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem interface
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End FTickableGameObject interface
+
+	/**
+	 * Returns the last known visibility of Target from Viewer and queues a new async test if the cached one is stale.
+	 *
+	 * @param	Viewer			Connection owner the test is done for. Its pawn is ignored by the traces.
+	 * @param	Target			Actor to test. Ignored by the traces.
+	 * @param	ViewLocation	Eye position of the viewer.
+	 * @param	TestPoints		Points on the target; the target is visible if any of them can be seen.
+	 */
+	bool IsVisibleTo(const APlayerController* Viewer, const AActor* Target, const FVector& ViewLocation, TArrayView<const FVector> TestPoints);
+
+private:
+
+	/** cached result for one viewer/target pair */
+	struct FVisibilityEntry
+	{
+		/** viewer location the last test was issued from */
+		FVector ViewLocation = FVector::ZeroVector;
+
+		/** target location the last test was issued for */
+		FVector TargetLocation = FVector::ZeroVector;
+
+		/** frame the last test was issued */
+		uint64 TestFrame = 0;
+
+		/** last frame anybody asked for this pair, used to drop entries of departed viewers/targets */
+		uint64 QueryFrame = 0;
+
+		/** async traces still in flight */
+		int32 PendingTraces = 0;
+
+		/** one of the in flight traces reached the viewer */
+		bool bPendingVisible = false;
+
+		/** last completed result */
+		bool bVisible = true;
+	};
+
+	/** async trace completion */
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	static uint64 MakePairKey(const APlayerController* Viewer, const AActor* Target)
+	{
+		return (uint64(Viewer->GetUniqueID()) << 32) | uint64(Target->GetUniqueID());
+	}
+
+	/** viewer/target pair -> index into Entries */
+	TMap<uint64, int32> EntryIndices;
+
+	/** stable storage so in flight traces can refer to their entry through FTraceDatum::UserData */
+	TSparseArray<FVisibilityEntry> Entries;
+
+	FTraceDelegate TraceDelegate;
+};
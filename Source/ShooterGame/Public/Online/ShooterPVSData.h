@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShooterPVSData.generated.h"
+
+/**
+ * Baked cell to cell potential visibility table for a map.
+ *
+ * The level bounds are divided into a 3D grid of cubic cells. For every pair of cells one bit says whether anything in one
+ * cell can possibly be seen from the other, going by static world geometry only. Baked with "ShooterRepGraph.PVS.Bake" and
+ * loaded by UShooterReplicationGraph from GetPackageNameForMap(). Lookups outside the grid are treated as visible.
+ */
+UCLASS()
+class UShooterPVSData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** min corner of the grid */
+	UPROPERTY(VisibleAnywhere, Category=PVS)
+	FVector Origin = FVector::ZeroVector;
+
+	/** edge length of a cell */
+	UPROPERTY(VisibleAnywhere, Category=PVS)
+	float CellSize = 0.f;
+
+	/** number of cells along each axis */
+	UPROPERTY(VisibleAnywhere, Category=PVS)
+	FIntVector NumCells = FIntVector::ZeroValue;
+
+	/** NumCells^2 visibility bits, row From, column To */
+	UPROPERTY()
+	TArray<uint32> VisibilityBits;
+
+	/** total number of cells in the grid */
+	int32 GetNumCells() const { return NumCells.X * NumCells.Y * NumCells.Z; }
+
+	/** true if a table was baked */
+	bool IsValid() const { return GetNumCells() > 0 && VisibilityBits.Num() == GetNumWords(GetNumCells()); }
+
+	/** cell containing Location, INDEX_NONE if outside the grid */
+	int32 GetCellIndex(const FVector& Location) const;
+
+	/** world space bounds of a cell */
+	FBox GetCellBounds(int32 CellIndex) const;
+
+	/** can anything in cell To be seen from cell From */
+	bool IsCellVisible(int32 FromCell, int32 ToCell) const
+	{
+		const int32 Bit = FromCell * GetNumCells() + ToCell;
+		return (VisibilityBits[Bit >> 5] & (1u << (Bit & 31))) != 0;
+	}
+
+	/** can To possibly be seen from From. Conservative: anything outside the grid is visible */
+	bool IsVisible(const FVector& From, const FVector& To) const;
+
+	/**
+	 * Bakes the table from the static geometry of World. Slow: traces between sample points of every pair of cells.
+	 *
+	 * @param	InCellSize			Edge length of a cell.
+	 * @param	SamplesPerCell		Sample points per cell. Two cells see each other if a ray between any pair of their samples is unblocked.
+	 * @param	MaxTraceDistance	Cell pairs further apart than this are marked visible without tracing (distance culling handles them).
+	 */
+	void Build(UWorld* World, float InCellSize, int32 SamplesPerCell, float MaxTraceDistance);
+
+	/** package the table for MapPackageName is saved to and loaded from, e.g. /Game/Maps/PVS/Highrise_PVS */
+	static FString GetPackageNameForMap(const FString& MapPackageName);
+
+	/** loads the baked table for World's map, nullptr if there is none */
+	static UShooterPVSData* LoadForWorld(UWorld* World);
+
+private:
+
+	static int32 GetNumWords(int32 InNumCells) { return (InNumCells * InNumCells + 31) / 32; }
+
+	void SetCellVisible(int32 FromCell, int32 ToCell)
+	{
+		const int32 Bit = FromCell * GetNumCells() + ToCell;
+		VisibilityBits[Bit >> 5] |= (1u << (Bit & 31));
+	}
+};
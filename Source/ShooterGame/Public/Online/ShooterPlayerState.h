@@ -60,14 +60,6 @@ class AShooterPlayerState : public APlayerState
 	/** gets truncated player name to fit in death log and scoreboards */
 	FString GetShortPlayerName() const;
 
-	/** Sends kill (excluding self) to clients */
-	UFUNCTION(Reliable, Client)
-	void InformAboutKill(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState);
-
-	/** broadcast death to local clients */
-	UFUNCTION(Reliable, NetMulticast)
-	void BroadcastDeath(class AShooterPlayerState* KillerPlayerState, const UDamageType* KillerDamageType, class AShooterPlayerState* KilledPlayerState);
-
 	/** replicate team colors. Updated the players mesh colors appropriately */
 	UFUNCTION()
 	void OnRep_TeamColor();
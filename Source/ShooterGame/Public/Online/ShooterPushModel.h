@@ -0,0 +1,45 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+/**
+ * Push model replication helpers.
+ *
+ * AShooterCharacter, AShooterWeapon and AShooterPlayerState register their replicated properties as push based, so they are only
+ * compared when marked dirty. Every write to one of them has to go through SHOOTER_MARK_PROPERTY_DIRTY, otherwise the change never
+ * reaches clients. The ShooterGame.Net.PushModel automation test records the marks (FShooterPushModelTracker) and fails on any
+ * replicated property that changes without one.
+ */
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** records which push based properties get marked dirty while a test is running */
+struct SHOOTERGAME_API FShooterPushModelTracker
+{
+	static void StartRecording();
+	static void StopRecording();
+
+	static void Record(const UObject* Object, FName PropertyName);
+
+	static bool WasMarked(const UObject* Object, FName PropertyName);
+
+private:
+
+	static bool bRecording;
+	static TSet<TPair<FObjectKey, FName>> MarkedProperties;
+};
+
+#define SHOOTER_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object) \
+	{ \
+		MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object); \
+		FShooterPushModelTracker::Record(Object, GET_MEMBER_NAME_CHECKED(ClassName, PropertyName)); \
+	}
+
+#else
+
+#define SHOOTER_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object) MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object)
+
+#endif
@@ -16,6 +16,12 @@ class AShooterPickup : public AActor
 	/** check if pawn can use this pickup */
 	virtual bool CanBePickedUp(class AShooterCharacter* TestPawn) const;
 
+	/** [server] counts the pickup as awake, the net driver doesn't get here for pickups dormant on every connection */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/** [server] sets the awake/dormant pickup stats: NumReplicated of Pickups went through PreReplication since the last update */
+	static void UpdateReplicationStats(const TArray<AShooterPickup*>& Pickups, int32 NumReplicated);
+
 protected:
 	/** initial setup */
 	virtual void BeginPlay() override;
@@ -75,6 +81,9 @@ protected:
 	/** show effects when pickup appears */
 	virtual void OnRespawned();
 
+	/** [server] push the state change out, the pickup is dormant the rest of the time */
+	void FlushPickupDormancy();
+
 	/** blueprint event: pickup disappears */
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnPickedUpEvent();
@@ -3,11 +3,71 @@
 #pragma once
 
 #include "ShooterTypes.h"
+#include "Engine/NetSerialization.h"
 #include "ShooterCharacter.generated.h"
 
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnShooterCharacterEquipWeapon, AShooterCharacter*, AShooterWeapon* /* new */);
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnShooterCharacterUnEquipWeapon, AShooterCharacter*, AShooterWeapon* /* old */);
 
+/** one weapon in a character's inventory */
+USTRUCT()
+struct FShooterInventoryEntry : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	class AShooterWeapon* Weapon = nullptr;
+
+	/** [client] OnEnterInventory was called for Weapon */
+	bool bEntered = false;
+
+	void PostReplicatedAdd(const struct FShooterInventory& InArraySerializer);
+	void PostReplicatedChange(const struct FShooterInventory& InArraySerializer);
+	void PreReplicatedRemove(const struct FShooterInventory& InArraySerializer);
+};
+
+/**
+ * Weapons in a character's inventory, replicated to the owner as deltas.
+ * Clients call OnEnterInventory / OnLeaveInventory on weapons as they are added to and removed from it.
+ */
+USTRUCT()
+struct FShooterInventory : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FShooterInventoryEntry> Items;
+
+	/** character this inventory belongs to */
+	class AShooterCharacter* Owner = nullptr;
+
+	int32 Num() const { return Items.Num(); }
+
+	class AShooterWeapon* GetWeapon(int32 Index) const { return Items[Index].Weapon; }
+
+	int32 IndexOf(const class AShooterWeapon* Weapon) const;
+
+	/** [server] adds a weapon, if it isn't in the inventory yet */
+	void Add(class AShooterWeapon* Weapon);
+
+	/** [server] removes a weapon */
+	void Remove(class AShooterWeapon* Weapon);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FShooterInventoryEntry, FShooterInventory>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterInventory> : public TStructOpsTypeTraitsBase2<FShooterInventory>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
 UCLASS(Abstract)
 class AShooterCharacter : public ACharacter
 {
@@ -256,6 +316,9 @@ class AShooterCharacter : public ACharacter
 	/** check if pawn is still alive */
 	bool IsAlive() const;
 
+	/** [server] pawn that last damaged us, if that happened less than MaxAge seconds ago */
+	AShooterCharacter* GetRecentAttacker(float MaxAge) const;
+
 	/** returns percentage of health when low health effects should start */
 	float GetLowHealthPercentage() const;
 
@@ -285,7 +348,7 @@ protected:
 
 	/** weapons in inventory */
 	UPROPERTY(Transient, Replicated)
-	TArray<class AShooterWeapon*> Inventory;
+	FShooterInventory Inventory;
 
 	/** currently equipped weapon */
 	UPROPERTY(Transient, ReplicatedUsing = OnRep_CurrentWeapon)
@@ -298,6 +361,9 @@ protected:
 	/** Time at which point the last take hit info for the actor times out and won't be replicated; Used to stop join-in-progress effects all over the screen */
 	float LastTakeHitTimeTimeout;
 
+	/** [server] time of the last hit recorded in LastTakeHitInfo */
+	float LastTakeHitTime;
+
 	/** modifier for max movement speed */
 	UPROPERTY(EditDefaultsOnly, Category = Inventory)
 	float TargetingSpeedModifier;
@@ -475,8 +541,11 @@ protected:
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerSetRunning(bool bNewRunning, bool bToggle);
 
-	/** Builds list of points to check for pausing replication for a connection*/
-	void BuildPauseReplicationCheckPoints(TArray<FVector>& RelevancyCheckPoints);
+	/** Number of points tested when checking if replication should be paused for a connection */
+	static const int32 NumPauseReplicationCheckPoints = 8;
+
+	/** Builds list of points to check for pausing replication for a connection (corners of the capsule bounds) */
+	void BuildPauseReplicationCheckPoints(FVector (&RelevancyCheckPoints)[NumPauseReplicationCheckPoints]) const;
 
 protected:
 	/** Returns Mesh1P subobject **/
@@ -44,6 +44,7 @@ class UShooterCharacterMovement : public UCharacterMovementComponent
     FVector SavedWallDirection;
     FVector SavedWallRunMovementDirection;
     uint8 bSavedWantsToWallRun : 1;
+    uint8 bSavedHoldingJump : 1;
   };
 
   //----------------------------------------------------------------------//
@@ -76,6 +77,21 @@ public:
   void OnActorHit(AActor* SelfActor, AActor* OtherActor, FVector NormalImpulse, const FHitResult& Hit);
   bool IsHoldingJump();
 
+  // Number of ServerMove RPCs this component has sent
+  int32 GetNumServerMovesSent() const { return NumServerMovesSent; }
+
+  // Number of world traces for walls this component has done
+  int32 GetNumWallTraces() const { return NumWallTraces; }
+
+  // Number of cached wall steps, each probing the cached wall component alone
+  int32 GetNumWallProbes() const { return NumWallProbes; }
+
+protected:
+  virtual void CallServerMove(const class FSavedMove_Character* NewMove, const class FSavedMove_Character* OldMove) override;
+
+  // ServerMove RPCs sent, counted to measure upstream move traffic
+  int32 NumServerMovesSent;
+
   //////////////////////////////////////////////////////////////////////////
   // Teleport
 
@@ -119,6 +135,16 @@ protected:
   // Checks for a wall in a certain direction, returning the hit result
   FHitResult CheckWallProximity(FVector Direction);
 
+  // Wall in a certain direction, from the wall contact cache while the character stays on the cached wall
+  FHitResult FindWall(const FVector& Direction);
+
+  // Is the capsule still over the cached wall: WallPoint (on its face) within its bounds and a probe at the leading edge hits it
+  bool IsOnCachedWall(UPrimitiveComponent* WallComponent, const FVector& WallPoint, float CapsuleRadius);
+
+  // Most the character can move along the cached wall before it is traced again, whatever the wall's bounds
+  UPROPERTY(EditDefaultsOnly, Category = "Movement|Wall Run")
+  float WallCacheTangentDistance;
+
   // Maximum distance from the wall to wall run
   UPROPERTY(EditDefaultsOnly, Category = "Movement|Wall Run")
   float WallMaxDistance;
@@ -139,10 +165,10 @@ protected:
   UPROPERTY(EditDefaultsOnly, Category = "Movement|Wall Run")
   float WallJumpForce;
 
-  // player is holding jump
+  // player is holding jump, sent to the server with each move (FLAG_Custom_1)
   bool bHoldingJump;
 
-  // The direction the wall is facing
+  // The direction the wall is facing, worked out by the server from its own replay of the move
   FVector WallDirection;
 
   // The direction character is moving
@@ -151,15 +177,14 @@ protected:
   // Gravity when not wall running
   float DefaultGravity;
 
-  // Wall direction replication
-  UFUNCTION(Unreliable, Server, WithValidation)
-  void Server_WallDirection(const FVector& Direction);
+  // World traces for walls and probes of the cached wall, counted to check the cache is used
+  int32 NumWallTraces;
+  int32 NumWallProbes;
 
-  // Movement direction replication
-  UFUNCTION(Unreliable, Server, WithValidation)
-  void Server_WallRunMovementDirection(const FVector& Direction);
-
-  // Holding jump replication
-  UFUNCTION(Unreliable, Server, WithValidation)
-  void Server_HoldingJump(bool IsHoldingJump);
+  // Wall contact cache, the last wall traced and where from
+  uint8 bHasCachedWall : 1;
+  FVector CachedWallPoint;
+  FVector CachedWallNormal;
+  FVector CachedWallTraceLocation;
+  TWeakObjectPtr<UPrimitiveComponent> CachedWallComponent;
 };
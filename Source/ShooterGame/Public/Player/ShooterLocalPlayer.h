@@ -21,7 +21,16 @@ public:
 	/** Initializes the PersistentUser */
 	void LoadPersistentUser();
 
+	/** Is any key bound to ActionName down? Cheap enough to ask every tick. */
+	bool IsActionKeyDown(FName ActionName);
+
+	/** Forgets the keys bound to each action, needed whenever the bindings change */
+	void InvalidateInputBindings();
+
 private:
+	/** Keys bound to each action asked about, resolved from the player input once */
+	TMap<FName, TArray<FKey>> ActionKeys;
+
 	/** Persistent user data stored between sessions (i.e. the user's savegame) */
 	UPROPERTY()
 	class UShooterPersistentUser* PersistentUser;
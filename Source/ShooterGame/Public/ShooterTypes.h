@@ -159,4 +159,20 @@ public:
 	FDamageEvent& GetDamageEvent();
 	void SetDamageEvent(const FDamageEvent& DamageEvent);
 	void EnsureReplication();
+
+	/**
+	 * Sends only the active damage event, and only what clients use of it (PlayHit / OnDeath): the shot direction for point damage,
+	 * the origin and first impact point for radial damage. Damage is sent in tenths, directions and locations quantized.
+	 * Clients get back an event whose GetBestHitInfo gives the same impulse direction as on the server.
+	 */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FTakeHitInfo> : public TStructOpsTypeTraitsBase2<FTakeHitInfo>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
 };
\ No newline at end of file
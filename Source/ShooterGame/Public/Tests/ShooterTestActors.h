@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "Player/ShooterCharacter.h"
+#include "Player/ShooterCharacterMovement.h"
+#include "Weapons/ShooterWeapon_Instant.h"
+#include "Pickups/ShooterPickup_Health.h"
+#include "Weapons/ShooterProjectile.h"
+#include "ShooterTestActors.generated.h"
+
+// The gameplay classes are abstract because their blueprints add the meshes, sounds and effects. These are the native parts only,
+// for automation tests that spawn them in an empty world.
+
+/** movement with fixed wall run settings (the gameplay ones are set in the blueprints), without gravity while wall running */
+UCLASS(NotBlueprintable, HideDropdown)
+class UShooterTestCharacterMovement : public UShooterCharacterMovement
+{
+	GENERATED_BODY()
+
+public:
+
+	UShooterTestCharacterMovement(const FObjectInitializer& ObjectInitializer);
+};
+
+UCLASS(NotPlaceable, NotBlueprintable, HideDropdown)
+class AShooterTestCharacter : public AShooterCharacter
+{
+	GENERATED_BODY()
+
+public:
+
+	AShooterTestCharacter(const FObjectInitializer& ObjectInitializer);
+};
+
+/** aims where it is told and records the shots it simulates from HitNotify */
+UCLASS(NotPlaceable, NotBlueprintable, HideDropdown)
+class AShooterTestWeapon_Instant : public AShooterWeapon_Instant
+{
+	GENERATED_BODY()
+
+public:
+
+	struct FSimulatedShot
+	{
+		int32 ShotIndex;
+		FVector ShootDir;
+	};
+
+	/** aim of every shot, instead of the instigator's */
+	FVector TestAim = FVector::ForwardVector;
+
+	/** [remote] shots simulated from HitNotify, in order */
+	TArray<FSimulatedShot> SimulatedShots;
+
+	virtual FVector GetAdjustedAim() const override { return TestAim; }
+
+	/** the spread stream the weapon shoots with, keyed the way its role keys it */
+	FShooterSpreadStream GetTestSpreadStream() { return GetSpreadStream(); }
+
+	/** [remote] gets NewHitNotify the way replication hands it over */
+	void ReceiveHitNotify(const FInstantHitInfo& NewHitNotify);
+
+protected:
+
+	virtual void SimulateInstantHit(const FVector& Origin, int32 ShotIndex, float ReticleSpread) override;
+};
+
+UCLASS(NotPlaceable, NotBlueprintable, HideDropdown)
+class AShooterTestPickup_Health : public AShooterPickup_Health
+{
+	GENERATED_BODY()
+};
+
+UCLASS(NotPlaceable, NotBlueprintable, HideDropdown)
+class AShooterTestProjectile : public AShooterProjectile
+{
+	GENERATED_BODY()
+};
@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc.All Rights Reserved.
+#pragma once
+
+#include "Tests/ShooterTestControllerDedicatedServerTest.h"
+#include "ShooterTestControllerServerMoveRate.generated.h"
+
+class UShooterCharacterMovement;
+
+// Joins a dedicated server like UShooterTestControllerDedicatedServerTest, then logs how many ServerMove RPCs the client sends per second.
+// Run headless clients with -nullrhi, -ServerMoveSampleTime= sets how long to sample, -ServerMoveIdle keeps the pawn still instead of running it back and forth.
+UCLASS()
+class UShooterTestControllerServerMoveRate : public UShooterTestControllerDedicatedServerTest
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnInit() override;
+	virtual void OnPostMapChange(UWorld* World) override;
+
+protected:
+	virtual void OnTick(float TimeDelta) override;
+
+	// Seconds to sample
+	float SampleTime;
+
+	// Seconds in game before sampling, for the pawn to spawn and the connection to settle
+	float WarmupTime;
+
+	uint8 bMovePawn : 1;
+	uint8 bWasInGame : 1;
+
+	float TimeInGame;
+	float TimeSampled;
+	int32 NumFramesSampled;
+	int32 NumServerMovesSampled;
+
+	// Movement sending the moves, changes when the pawn respawns
+	TWeakObjectPtr<UShooterCharacterMovement> SampledMovement;
+	int32 LastNumServerMovesSent;
+};
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/** empty game world for automation tests, playing once constructed and torn down with its world context when it goes out of scope */
+class FShooterTestWorld
+{
+public:
+
+	explicit FShooterTestWorld(const TCHAR* Name);
+	~FShooterTestWorld();
+
+	UWorld* Get() const { return World; }
+	UWorld* operator->() const { return World; }
+
+private:
+
+	FShooterTestWorld(const FShooterTestWorld&) = delete;
+	FShooterTestWorld& operator=(const FShooterTestWorld&) = delete;
+
+	UWorld* World;
+};
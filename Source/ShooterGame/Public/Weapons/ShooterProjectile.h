@@ -25,6 +25,24 @@ class AShooterProjectile : public AActor
 	UFUNCTION()
 	void OnImpact(const FHitResult& HitResult);
 
+	/** [server] parks the projectile in the pool: hidden, stopped and dormant */
+	void EnterPool();
+
+	/** [server] takes the projectile out of the pool for a new shot */
+	void LeavePool(const FTransform& SpawnTransform, const FVector& ShootDirection, AActor* NewOwner, APawn* NewInstigator);
+
+	/** makes it a local, non replicated stand-in for an AShooterProjectileManager projectile, call before FinishSpawning */
+	void InitVisual();
+
+	/** [visual] the manager's projectile exploded */
+	void ExplodeVisual(const FVector& ImpactPoint, const FVector& ImpactNormal);
+
+	/** speed it is fired with */
+	float GetInitialSpeed() const;
+
+	/** radius of the collision sphere */
+	float GetCollisionRadius() const;
+
 private:
 	/** movement component */
 	UPROPERTY(VisibleDefaultsOnly, Category=Projectile)
@@ -52,10 +70,30 @@ protected:
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_Exploded)
 	bool bExploded;
 
+	/** only shows a projectile simulated by AShooterProjectileManager: no damage, explodes when told to */
+	bool bVisualOnly;
+
 	/** [client] explosion happened */
 	UFUNCTION()
 	void OnRep_Exploded();
 
+	/** is it waiting in UShooterProjectilePoolSubsystem? */
+	UPROPERTY(Transient, ReplicatedUsing=OnRep_Pooled)
+	bool bPooled;
+
+	/** [client] went into or came out of the pool */
+	UFUNCTION()
+	void OnRep_Pooled();
+
+	/** hides and stops everything while pooled, restarts it otherwise */
+	void ApplyPooledState();
+
+	/** per shot setup: weapon config, life span and instigator */
+	void InitProjectile();
+
+	/** [server] back to the pool instead of being destroyed */
+	virtual void LifeSpanExpired() override;
+
 	/** trigger explosion */
 	void Explode(const FHitResult& Impact);
 
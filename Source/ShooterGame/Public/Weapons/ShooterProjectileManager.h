@@ -0,0 +1,186 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/Info.h"
+#include "Engine/NetSerialization.h"
+#include "ShooterWeapon_Projectile.h"
+#include "ShooterProjectileManager.generated.h"
+
+class AShooterProjectile;
+class AShooterProjectileManager;
+
+/**
+ * Projectiles in flight as parallel arrays, stepped in one pass: a sphere sweep along each one's velocity.
+ * Hits and expired projectiles are removed and reported, what happens to them is up to the caller.
+ */
+struct FShooterProjectileSimulation
+{
+	struct FImpact
+	{
+		int32 Id;
+		int32 ConfigIndex;
+		TWeakObjectPtr<AController> Owner;
+		FHitResult Hit;
+	};
+
+	/** starts simulating a projectile, returns its id */
+	int32 Add(const FVector& Location, const FVector& Velocity, float Radius, float TimeLeft, APawn* Instigator, AController* Owner, int32 ConfigIndex);
+
+	/** moves every projectile by DeltaTime */
+	void Step(UWorld* World, float DeltaTime, TArray<FImpact>& OutImpacts, TArray<int32>& OutExpiredIds);
+
+	void Reset();
+
+	int32 Num() const { return Ids.Num(); }
+
+	TArray<int32> Ids;
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<float> Radii;
+	TArray<float> TimesLeft;
+	TArray<int32> ConfigIndices;
+
+	/** ignored by the sweeps, like the projectile actor's MoveIgnoreActors */
+	TArray<TWeakObjectPtr<APawn>> Instigators;
+
+	/** damage instigator */
+	TArray<TWeakObjectPtr<AController>> Owners;
+
+private:
+
+	void RemoveAtSwap(int32 Index);
+
+	int32 LastId = 0;
+};
+
+/** a managed projectile as clients see it: where and where to it was fired, and where it exploded */
+USTRUCT()
+struct FShooterManagedProjectile : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	int32 Id = 0;
+
+	/** shown as this class */
+	UPROPERTY()
+	TSubclassOf<AShooterProjectile> ProjectileClass;
+
+	UPROPERTY()
+	APawn* Instigator = nullptr;
+
+	UPROPERTY()
+	FVector_NetQuantize Origin;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	/** server world time it was fired */
+	UPROPERTY()
+	float SpawnTime = 0.f;
+
+	UPROPERTY()
+	bool bExploded = false;
+
+	UPROPERTY()
+	FVector_NetQuantize ImpactPoint;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal ImpactNormal;
+
+	/** [server] world time to stop replicating it */
+	float RemoveTime = 0.f;
+
+	/** projectile actor showing it */
+	TWeakObjectPtr<AShooterProjectile> Visual;
+
+	void PostReplicatedAdd(const struct FShooterManagedProjectiles& InArraySerializer);
+	void PostReplicatedChange(const struct FShooterManagedProjectiles& InArraySerializer);
+	void PreReplicatedRemove(const struct FShooterManagedProjectiles& InArraySerializer);
+};
+
+USTRUCT()
+struct FShooterManagedProjectiles : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FShooterManagedProjectile> Items;
+
+	/** not replicated, set by the manager */
+	AShooterProjectileManager* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FShooterManagedProjectile, FShooterManagedProjectiles>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterManagedProjectiles> : public TStructOpsTypeTraitsBase2<FShooterManagedProjectiles>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Rockets without a replicated actor each (p.ProjectileManager).
+ *
+ * The server simulates them in FShooterProjectileSimulation and applies the explosion damage. Clients get one fast
+ * array entry per projectile, spawned when it is fired and changed when it explodes, and show it with a local,
+ * non replicated AShooterProjectile.
+ */
+UCLASS()
+class AShooterProjectileManager : public AInfo
+{
+	GENERATED_UCLASS_BODY()
+
+	/** [server] the world's manager, spawned on first use */
+	static AShooterProjectileManager* Get(UWorld* World);
+
+	/** are projectiles fired through the manager? */
+	static bool IsEnabled();
+
+	/** [server] fires a projectile of Config's class */
+	void SpawnProjectile(const FProjectileWeaponData& Config, const FVector& Origin, const FVector& ShootDir, APawn* Instigator);
+
+	/** [server] steps the projectiles */
+	virtual void Tick(float DeltaSeconds) override;
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** [client] entry of a projectile arrived or changed */
+	void OnProjectileReceived(FShooterManagedProjectile& Projectile);
+
+	/** [client] entry of a projectile is going away */
+	void OnProjectileRemoved(FShooterManagedProjectile& Projectile);
+
+protected:
+
+	UPROPERTY(Transient, Replicated)
+	FShooterManagedProjectiles Projectiles;
+
+	/** [server] configs of the weapons that fired, indexed by FShooterProjectileSimulation::ConfigIndices */
+	TArray<FProjectileWeaponData> Configs;
+
+	FShooterProjectileSimulation Simulation;
+
+	int32 FindOrAddConfig(const FProjectileWeaponData& Config);
+
+	/** spawns the actor showing Projectile, if it isn't too late for that */
+	void SpawnVisual(FShooterManagedProjectile& Projectile);
+
+	/** plays the explosion on Projectile's actor */
+	void ExplodeVisual(FShooterManagedProjectile& Projectile);
+
+	/** do projectiles need an actor to be seen here? */
+	bool ShouldShowVisuals() const;
+
+	/** manager of each playing world, found without looking through the world's actors on every shot */
+	static TMap<FObjectKey, TWeakObjectPtr<AShooterProjectileManager>> WorldManagers;
+};
@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterProjectilePoolSubsystem.generated.h"
+
+class AShooterProjectile;
+
+/**
+ * [server] Recycles projectile actors instead of spawning one per shot and destroying it after the explosion.
+ *
+ * Finished projectiles are hidden, parked and made dormant, which closes their actor channels without destroying
+ * the actor on clients. Taking one out of the pool wakes it up, the channel reopens on the same actor and
+ * AShooterProjectile::OnRep_Pooled brings it back on the clients. Disabled with p.ProjectilePooling 0, the
+ * spawn and garbage collection totals are logged when the world goes away to compare both.
+ */
+UCLASS()
+class UShooterProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem interface
+
+	/**
+	 * Projectile of Class flying along ShootDirection from SpawnTransform, reused from the pool when there is a free one.
+	 * Set up the same way either way: weapon config from Owner, life span and instigator.
+	 */
+	AShooterProjectile* SpawnProjectile(TSubclassOf<AShooterProjectile> Class, const FTransform& SpawnTransform, const FVector& ShootDirection, AActor* Owner, APawn* Instigator);
+
+	/** takes back a projectile that is done, false if it has to be destroyed instead */
+	bool ReleaseProjectile(AShooterProjectile* Projectile);
+
+	/** fills the pool of Class up to p.ProjectilePoolPrewarm free projectiles */
+	void Prewarm(TSubclassOf<AShooterProjectile> Class, const FTransform& SpawnTransform);
+
+private:
+
+	AShooterProjectile* SpawnNewProjectile(TSubclassOf<AShooterProjectile> Class, const FTransform& SpawnTransform, const FVector& ShootDirection, AActor* Owner, APawn* Instigator);
+
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	/** free projectiles by class */
+	TMap<FObjectKey, TArray<TWeakObjectPtr<AShooterProjectile>>> FreeProjectiles;
+
+	int32 NumSpawned = 0;
+	int32 NumReused = 0;
+	int32 NumDestroyed = 0;
+
+	int32 NumGarbageCollections = 0;
+	double GarbageCollectStartTime = 0.0;
+	double GarbageCollectSeconds = 0.0;
+
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+};
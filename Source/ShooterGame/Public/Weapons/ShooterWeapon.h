@@ -478,6 +478,9 @@ protected:
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerHandleFiring();
 
+	/** [local] tells the server HandleFiring ran, instant hit weapons batch this with their shots */
+	virtual void NotifyServerOfFiring();
+
 	/** [local + server] handle weapon refire, compensating for slack time if the timer can't sample fast enough */
 	void HandleReFiring();
 
@@ -7,6 +7,26 @@
 
 class AShooterImpactEffect;
 
+/**
+ * Spread of a weapon's shots as a function of the shot index: a counter based generator keyed by the weapon's net GUID.
+ * Every machine derives the same directions from the index alone, no seed has to be sent with the shots.
+ */
+struct FShooterSpreadStream
+{
+	explicit FShooterSpreadStream(uint32 InKey)
+		: Key(InKey)
+	{
+	}
+
+	/** random seed of shot ShotIndex */
+	int32 GetSeed(int32 ShotIndex) const;
+
+	/** direction of shot ShotIndex, within a cone of ConeHalfAngle radians around AimDir */
+	FVector GetShotDir(int32 ShotIndex, const FVector& AimDir, float ConeHalfAngle) const;
+
+	uint32 Key;
+};
+
 USTRUCT()
 struct FInstantHitInfo
 {
@@ -18,8 +38,63 @@ struct FInstantHitInfo
 	UPROPERTY()
 	float ReticleSpread;
 
+	/** index of the newest shot, the ones fired since the last update are regenerated from it */
 	UPROPERTY()
-	int32 RandomSeed;
+	int32 ShotIndex;
+};
+
+/**
+ * One HandleFiring on a client and the shot it fired, if any, as sent to the server in a batch (ServerFireShots).
+ * Hits carry the distance along the shot and the hit actor and bone instead of a full FHitResult.
+ */
+USTRUCT()
+struct FShooterBatchedShot
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** what the shot hit */
+	enum EHitType
+	{
+		Miss,
+		HitWorld,
+		HitActor,
+	};
+
+	/** a shot was fired (ServerNotifyHit / ServerNotifyMiss) */
+	bool bFired = false;
+
+	/** HandleFiring ran after it (ServerHandleFiring) */
+	bool bHandleFiring = false;
+
+	uint8 HitType = Miss;
+
+	/** trace start */
+	FVector_NetQuantize Origin;
+
+	FVector_NetQuantizeNormal ShootDir;
+
+	/** index in the weapon's spread stream */
+	int32 ShotIndex = 0;
+
+	float ReticleSpread = 0.f;
+
+	/** from Origin to the impact along ShootDir */
+	float HitDistance = 0.f;
+
+	TWeakObjectPtr<AActor> HitActor;
+
+	FName BoneName;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterBatchedShot> : public TStructOpsTypeTraitsBase2<FShooterBatchedShot>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
 };
 
 USTRUCT()
@@ -63,6 +138,10 @@ struct FInstantWeaponData
 	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
 	float AllowedViewDotHitDir;
 
+	/** hit verification: distance a hit may be from the target's hitboxes at the time the client fired (lag compensation) */
+	UPROPERTY(EditDefaultsOnly, Category=HitVerification)
+	float LagCompensationLeeway;
+
 	/** defaults */
 	FInstantWeaponData()
 	{
@@ -75,6 +154,7 @@ struct FInstantWeaponData
 		DamageType = UDamageType::StaticClass();
 		ClientSideHitLeeway = 200.0f;
 		AllowedViewDotHitDir = 0.8f;
+		LagCompensationLeeway = 20.0f;
 	}
 };
 
@@ -87,6 +167,8 @@ class AShooterWeapon_Instant : public AShooterWeapon
 	/** get current spread */
 	float GetCurrentSpread() const;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 protected:
 
 	virtual EAmmoType GetAmmoType() const override
@@ -117,22 +199,56 @@ protected:
 	/** current spread from continuous firing */
 	float CurrentFiringSpread;
 
+	/** [local + server] index of the last shot fired */
+	int32 ShotCounter;
+
+	/** [remote] index of the last shot simulated from HitNotify, INDEX_NONE until the first one */
+	int32 LastSimulatedShotIndex;
+
+	/** [local] shots fired this frame, sent to the server in one RPC at the end of it */
+	TArray<FShooterBatchedShot> PendingShots;
+
+	/** end of frame callback sending PendingShots */
+	FDelegateHandle FlushPendingShotsHandle;
+
 	//////////////////////////////////////////////////////////////////////////
 	// Weapon usage
 
 	/** server notified of hit from client to verify */
 	UFUNCTION(reliable, server, WithValidation)
-	void ServerNotifyHit(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+	void ServerNotifyHit(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 ShotIndex, float ReticleSpread);
 
 	/** server notified of miss to show trail FX */
 	UFUNCTION(unreliable, server, WithValidation)
-	void ServerNotifyMiss(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+	void ServerNotifyMiss(FVector_NetQuantizeNormal ShootDir, int32 ShotIndex, float ReticleSpread);
+
+	/** server notified of the shots and HandleFiring calls of one client frame, replaces the three RPCs above (p.ShotBatching) */
+	UFUNCTION(reliable, server, WithValidation)
+	void ServerFireShots(const TArray<FShooterBatchedShot>& Shots);
+
+	/** [local] sends a shot to the server, right away or with the next batch */
+	void NotifyServerOfShot(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 ShotIndex, float ReticleSpread);
+
+	/** [local] adds HandleFiring to the batch */
+	virtual void NotifyServerOfFiring() override;
+
+	/** [local] new entry in PendingShots, makes sure it gets sent at the end of the frame */
+	FShooterBatchedShot& AddPendingShot();
+
+	/** [local] sends PendingShots */
+	void FlushPendingShots(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** spread stream of this weapon, the same on the server and every client */
+	FShooterSpreadStream GetSpreadStream();
+
+	/** [server] hit result for a batched shot */
+	FHitResult MakeHitResult(const FShooterBatchedShot& Shot) const;
 
 	/** process the instant hit and notify the server if necessary */
-	void ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
+	void ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 ShotIndex, float ReticleSpread);
 
 	/** continue processing the instant hit, as if it has been confirmed by the server */
-	void ProcessInstantHit_Confirmed(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
+	void ProcessInstantHit_Confirmed(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 ShotIndex, float ReticleSpread);
 
 	/** check if weapon should deal damage to actor */
 	bool ShouldDealDamage(AActor* TestActor) const;
@@ -154,7 +270,10 @@ protected:
 	void OnRep_HitNotify();
 
 	/** called in network play to do the cosmetic fx  */
-	void SimulateInstantHit(const FVector& Origin, int32 RandomSeed, float ReticleSpread);
+	virtual void SimulateInstantHit(const FVector& Origin, int32 ShotIndex, float ReticleSpread);
+
+	/** [remote] direction of shot ShotIndex, regenerated from the spread stream */
+	FVector GetSimulatedShotDir(int32 ShotIndex, float ReticleSpread);
 
 	/** spawn effects for impact */
 	void SpawnImpactEffects(const FHitResult& Impact);
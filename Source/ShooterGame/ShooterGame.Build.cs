@@ -42,6 +42,7 @@ public class ShooterGame : ModuleRules
 				"Json",
 				"ApplicationCore",
 				"ReplicationGraph",
+				"NetCore",
 				"PakFile",
 				"RHI"
 			}
@@ -9,6 +9,9 @@ public class ShooterGameEditorTarget : TargetRules
 	{
 		Type = TargetType.Editor;
 
+		// Replicated properties of the character, weapons and player state are push based (see ShooterPushModel.h)
+		bWithPushModel = true;
+
 		ExtraModuleNames.Add("ShooterGame");
 	}
 }
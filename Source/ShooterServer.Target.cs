@@ -11,6 +11,9 @@ public class ShooterServerTarget : TargetRules
 		Type = TargetType.Server;
 		bUsesSteam = true;
 
+		// Replicated properties of the character, weapons and player state are push based (see ShooterPushModel.h)
+		bWithPushModel = true;
+
 		ExtraModuleNames.Add("ShooterGame");
 	}
 }